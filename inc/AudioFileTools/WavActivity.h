@@ -0,0 +1,94 @@
+/// WavActivity.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_ACTIVITY_H
+#define WAV_ACTIVITY_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** Options for detecting active audio */
+struct WavActivityOptions {
+    /** The level, in dB relative to full scale, above which audio is active */
+    float thresholdDb = -50.0f;
+    /** The number of frames whose peak level is compared to the threshold */
+    size_t windowFrames = 480;
+    /** Silences shorter than this many frames do not split a region */
+    size_t minSilenceFrames = 9600;
+    /** Regions shorter than this many frames are dropped */
+    size_t minActiveFrames = 4800;
+};
+
+/** A region of active audio */
+struct WavActivityRegion {
+    /** The first frame of the region */
+    uint32_t start = 0;
+    /** The number of frames in the region */
+    uint32_t length = 0;
+
+    auto operator==(const WavActivityRegion &) const -> bool = default;
+};
+
+/**
+ * @brief Finds the active regions of a WAV file.
+ * @details The payload is streamed in blocks and compared against the
+ * threshold in the file's own sample format, so PCM files are never
+ * converted to float. Region boundaries fall on window boundaries.
+ * @param filename The filename of the WAV file
+ * @param options The detection options
+ * @return The active regions in order, or std::nullopt if the file is not a
+ * valid WAV file
+ */
+auto detect_wav_activity(const std::string &filename,
+                         const WavActivityOptions &options = {})
+        -> std::optional<std::vector<WavActivityRegion>>;
+
+/**
+ * @brief Stores regions in a WAV file as a 'cue ' chunk and a 'LIST' chunk
+ * of 'adtl' labelled text entries.
+ * @details The chunks are appended to the end of the file and the RIFF size
+ * is updated, so the audio is not rewritten. Each region becomes a cue point
+ * at its start with an 'ltxt' entry holding its length, which other audio
+ * tools show as a region. An index written by an earlier call is replaced.
+ * The file can then no longer be reopened with WavWriter::open_append().
+ * @param filename The filename of the WAV file
+ * @param regions The regions
+ * @return True if the chunks were written, false otherwise
+ */
+auto write_wav_activity_index(const std::string &filename,
+                              const std::vector<WavActivityRegion> &regions)
+        -> bool;
+
+/**
+ * @brief Reads the regions stored by write_wav_activity_index().
+ * @param filename The filename of the WAV file
+ * @return The regions in order, or std::nullopt if the file has no index
+ */
+auto read_wav_activity_index(const std::string &filename)
+        -> std::optional<std::vector<WavActivityRegion>>;
+
+#endif // WAV_ACTIVITY_H
@@ -0,0 +1,159 @@
+/// WavAsync.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_ASYNC_H
+#define WAV_ASYNC_H
+
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "WavReader.h"
+#include "WavThreadPool.h"
+#include "WavWriter.h"
+
+/**
+ * @brief Awaitable that runs a blocking operation on a thread pool.
+ * @details Awaiting it suspends the coroutine, runs the operation on one of
+ * the pool's workers and resumes the coroutine on that worker with the
+ * operation's result, so the awaiting thread is never blocked.
+ * @tparam Operation The type of the operation
+ */
+template<typename Operation>
+class WavPoolAwaitable {
+public:
+    /** The type returned by the operation */
+    using Result = std::invoke_result_t<Operation &>;
+
+    /**
+     * @brief Public constructor
+     * @param pool The pool running the operation
+     * @param operation The operation
+     */
+    WavPoolAwaitable(WavThreadPool &pool, Operation operation) :
+        m_pool(pool), m_operation(std::move(operation)) {}
+
+    /** The operation always runs on the pool */
+    auto await_ready() const noexcept -> bool { return false; }
+
+    /**
+     * @brief Queues the operation and the resumption of the coroutine.
+     * @param handle The awaiting coroutine
+     */
+    auto await_suspend(std::coroutine_handle<> handle) -> void {
+        m_pool.submit([this, handle] {
+            if constexpr (std::is_void_v<Result>) {
+                m_operation();
+            } else {
+                m_result.emplace(m_operation());
+            }
+            handle.resume();
+        });
+    }
+
+    /**
+     * @brief Gets the result of the operation.
+     * @return The result of the operation
+     */
+    auto await_resume() -> Result {
+        if constexpr (!std::is_void_v<Result>) {
+            return std::move(*m_result);
+        }
+    }
+
+private:
+    /** Placeholder result type for operations that return nothing */
+    struct Empty {};
+
+    /** The pool running the operation */
+    WavThreadPool &m_pool;
+
+    /** The operation */
+    Operation m_operation;
+
+    /** The result of the operation, once it has run */
+    std::optional<std::conditional_t<std::is_void_v<Result>, Empty, Result>>
+            m_result;
+};
+
+/**
+ * @brief Reads samples from the reader's current position on a thread pool.
+ * @details Only one read() based operation may be outstanding per reader at a
+ * time, since they share the reader's cursor.
+ * @tparam T The type to convert the samples to
+ * @param pool The pool running the read
+ * @param reader The reader, which must outlive the operation
+ * @param count The number of frames to read
+ * @return An awaitable yielding the samples, one vector per channel
+ */
+template<AllowedAudioDataType T>
+auto async_read(WavThreadPool &pool, WavReader &reader, const size_t count) {
+    return WavPoolAwaitable(pool, [&reader, count] {
+        return reader.read<T>(count);
+    });
+}
+
+/**
+ * @brief Reads samples from a given position on a thread pool.
+ * @details Any number of these may be outstanding on the same reader.
+ * @tparam T The type to convert the samples to
+ * @param pool The pool running the read
+ * @param reader The reader, which must outlive the operation
+ * @param frame The index of the first frame to read
+ * @param count The number of frames to read
+ * @param sampleArrays The output samples, one array per channel, which must
+ * outlive the operation
+ * @return An awaitable yielding the number of frames read
+ */
+template<AllowedAudioDataType T>
+auto async_read_at(WavThreadPool &pool, const WavReader &reader,
+                   const size_t frame, const size_t count,
+                   T *const *sampleArrays) {
+    return WavPoolAwaitable(pool, [&reader, frame, count, sampleArrays] {
+        return reader.read_at(frame, count, sampleArrays);
+    });
+}
+
+/**
+ * @brief Writes samples to the WAV file on a thread pool.
+ * @details Only one write may be outstanding per writer at a time.
+ * @param pool The pool running the write
+ * @param writer The writer, which must outlive the operation
+ * @param sampleArrays The samples, one array per channel, which must outlive
+ * the operation
+ * @param count The number of frames to write
+ * @return An awaitable that completes once the samples are written
+ */
+auto async_write(WavThreadPool &pool, WavWriter &writer,
+                 AllowedAudioDataType auto *const *sampleArrays,
+                 const size_t count) {
+    return WavPoolAwaitable(pool, [&writer, sampleArrays, count] {
+        writer.write_buffer(sampleArrays, count);
+    });
+}
+
+#endif // WAV_ASYNC_H
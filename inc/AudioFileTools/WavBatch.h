@@ -0,0 +1,106 @@
+/// WavBatch.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_BATCH_H
+#define WAV_BATCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+#include "WavThreadPool.h"
+
+/** A conversion job: the WAV file to read and the configuration to write */
+struct WavBatchJob {
+    std::string input;
+    WavFileConfiguration output;
+};
+
+/** The outcome of a conversion job */
+struct WavBatchResult {
+    /** Whether the output file was written completely */
+    bool success = false;
+    /** The number of frames converted */
+    uint64_t frames = 0;
+    /** Time spent queued before a worker picked up the job */
+    std::chrono::nanoseconds queueTime{0};
+    /** Time spent running the job */
+    std::chrono::nanoseconds runTime{0};
+};
+
+/** Options for batch conversion */
+struct WavBatchOptions {
+    /** The number of worker threads, or 0 to use one per hardware thread */
+    size_t numThreads = 0;
+    /** The upper bound on the sample buffers held by all running jobs. Each
+     * worker thread also keeps one raw read buffer of up to 1 MiB, reused
+     * across jobs */
+    size_t maxInFlightBytes = 64 << 20;
+};
+
+/**
+ * @brief Batch converter that transcodes many WAV files on a work-stealing
+ * thread pool.
+ * @details Each job streams its input block by block through a WavReader and
+ * a WavWriter. With several jobs running at once, the file I/O of some jobs
+ * overlaps the sample conversion of others. The block size of each job is
+ * chosen so that the buffers of all running jobs fit in the memory budget.
+ */
+class WavBatchConverter {
+public:
+    /**
+     * @brief Public constructor that starts the worker threads.
+     * @param options The batch conversion options
+     */
+    explicit WavBatchConverter(WavBatchOptions options = {});
+
+    /**
+     * @brief Runs a list of conversion jobs and waits for them to finish.
+     * @details The input and output must have the same number of channels
+     * and sample rate, since samples are converted but not resampled.
+     * @param jobs The conversion jobs
+     * @return The outcome of each job, in the same order as the jobs
+     */
+    auto convert(const std::vector<WavBatchJob> &jobs)
+            -> std::vector<WavBatchResult>;
+
+private:
+    /**
+     * @brief Runs a single conversion job.
+     * @param job The conversion job
+     * @param result The outcome of the job
+     */
+    auto run_job(const WavBatchJob &job, WavBatchResult &result) const -> void;
+
+    /** The batch conversion options */
+    WavBatchOptions m_options;
+
+    /** The pool running the jobs */
+    WavThreadPool m_pool;
+};
+
+#endif // WAV_BATCH_H
@@ -0,0 +1,275 @@
+/// WavConversion.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_CONVERSION_H
+#define WAV_CONVERSION_H
+
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+
+#include "WavConfiguration.h"
+#include "WavUtils.h"
+
+/**
+ * @brief Converts a sample between any two of the allowed audio data types.
+ * @tparam From The type of the input sample
+ * @tparam To The type of the output sample
+ * @param sample The input sample
+ * @return The converted sample
+ */
+template<AllowedAudioDataType From, AllowedAudioDataType To>
+auto convert_sample(const From sample) -> To {
+    if constexpr (std::same_as<From, To>) {
+        return sample;
+    } else if constexpr (std::same_as<From, float>) {
+        if constexpr (std::same_as<To, uint8_t>)
+            return convert_float_to_uint8(sample);
+        if constexpr (std::same_as<To, int16_t>)
+            return convert_float_to_int16(sample);
+        if constexpr (std::same_as<To, int32_t>)
+            return convert_float_to_int32(sample);
+    } else if constexpr (std::same_as<From, uint8_t>) {
+        if constexpr (std::same_as<To, float>)
+            return convert_uint8_to_float(sample);
+        if constexpr (std::same_as<To, int16_t>)
+            return convert_uint8_to_int16(sample);
+        if constexpr (std::same_as<To, int32_t>)
+            return convert_uint8_to_int32(sample);
+    } else if constexpr (std::same_as<From, int16_t>) {
+        if constexpr (std::same_as<To, float>)
+            return convert_int16_to_float(sample);
+        if constexpr (std::same_as<To, uint8_t>)
+            return convert_int16_to_uint8(sample);
+        if constexpr (std::same_as<To, int32_t>)
+            return convert_int16_to_int32(sample);
+    } else if constexpr (std::same_as<From, int32_t>) {
+        if constexpr (std::same_as<To, float>)
+            return convert_int32_to_float(sample);
+        if constexpr (std::same_as<To, uint8_t>)
+            return convert_int32_to_uint8(sample);
+        if constexpr (std::same_as<To, int16_t>)
+            return convert_int32_to_int16(sample);
+    }
+}
+
+/**
+ * @brief Converts a sample of any of the allowed audio data types to an int24
+ * sample, which is stored in an int32_t.
+ * @tparam From The type of the input sample
+ * @param sample The input sample
+ * @return The int24 sample
+ */
+template<AllowedAudioDataType From>
+auto convert_sample_to_int24(const From sample) -> int32_t {
+    if constexpr (std::same_as<From, float>)
+        return convert_float_to_int24(sample);
+    if constexpr (std::same_as<From, uint8_t>)
+        return convert_uint8_to_int24(sample);
+    if constexpr (std::same_as<From, int16_t>)
+        return convert_int16_to_int24(sample);
+    if constexpr (std::same_as<From, int32_t>)
+        return convert_int32_to_int24(sample);
+}
+
+/**
+ * @brief Converts an int24 sample, which is stored in an int32_t, to any of
+ * the allowed audio data types.
+ * @tparam To The type of the output sample
+ * @param sample The int24 sample
+ * @return The converted sample
+ */
+template<AllowedAudioDataType To>
+auto convert_sample_from_int24(const int32_t sample) -> To {
+    if constexpr (std::same_as<To, float>)
+        return convert_int24_to_float(sample);
+    if constexpr (std::same_as<To, uint8_t>)
+        return convert_int24_to_uint8(sample);
+    if constexpr (std::same_as<To, int16_t>)
+        return convert_int24_to_int16(sample);
+    if constexpr (std::same_as<To, int32_t>)
+        return convert_int24_to_int32(sample);
+}
+
+/**
+ * @brief Converts and interleaves samples into a buffer of output samples.
+ * @tparam From The type of the input samples
+ * @tparam To The type of the output samples
+ * @param sampleArrays The input samples, one array per channel
+ * @param count The number of frames to encode
+ * @param numChannels The number of channels
+ * @param output The output buffer, which does not need to be aligned
+ */
+template<AllowedAudioDataType From, AllowedAudioDataType To>
+auto encode_interleaved(const From *const *sampleArrays, const size_t count,
+                        const size_t numChannels, uint8_t *output) -> void {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            const To sample = convert_sample<From, To>(sampleArrays[ch][i]);
+            std::memcpy(output + (i * numChannels + ch) * sizeof(To), &sample,
+                        sizeof(To));
+        }
+    }
+}
+
+/**
+ * @brief Converts and interleaves samples into the sample format of a WAV
+ * file.
+ * @tparam T The type of the input samples
+ * @param sampleArrays The input samples, one array per channel
+ * @param count The number of frames to encode
+ * @param config The configuration describing the output format
+ * @param output The output buffer, which must hold count * blockAlign bytes
+ */
+template<AllowedAudioDataType T>
+auto encode_frames(const T *const *sampleArrays, const size_t count,
+                   const WavFileConfiguration &config, uint8_t *output)
+        -> void {
+    const size_t numChannels = config.numChannels;
+    /// Float-32 output format
+    if (config.format == WavFormat::FLOAT) {
+        encode_interleaved<T, float>(sampleArrays, count, numChannels, output);
+        return;
+    }
+    switch (config.bitDepth) {
+        /// PCM-8 output format
+        case WavBitDepth::BIT_DEPTH_8: {
+            encode_interleaved<T, uint8_t>(sampleArrays, count, numChannels,
+                                           output);
+            break;
+        }
+        /// PCM-16 output format
+        case WavBitDepth::BIT_DEPTH_16: {
+            encode_interleaved<T, int16_t>(sampleArrays, count, numChannels,
+                                           output);
+            break;
+        }
+        /// PCM-24 output format
+        case WavBitDepth::BIT_DEPTH_24: {
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    const int32_t sample =
+                            convert_sample_to_int24(sampleArrays[ch][i]);
+                    uint8_t *bytes = output + (i * numChannels + ch) * 3;
+                    bytes[0] = static_cast<uint8_t>(sample & 0xFF);
+                    bytes[1] = static_cast<uint8_t>((sample >> 8) & 0xFF);
+                    bytes[2] = static_cast<uint8_t>((sample >> 16) & 0xFF);
+                }
+            }
+            break;
+        }
+        /// PCM-32 output format
+        case WavBitDepth::BIT_DEPTH_32: {
+            encode_interleaved<T, int32_t>(sampleArrays, count, numChannels,
+                                           output);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Deinterleaves and converts a buffer of input samples.
+ * @tparam From The type of the input samples
+ * @tparam To The type of the output samples
+ * @param input The input buffer, which does not need to be aligned
+ * @param count The number of frames to decode
+ * @param numChannels The number of channels
+ * @param sampleArrays The output samples, one array per channel
+ * @param offset The index in each output array of the first decoded frame
+ */
+template<AllowedAudioDataType From, AllowedAudioDataType To>
+auto decode_interleaved(const uint8_t *input, const size_t count,
+                        const size_t numChannels, To *const *sampleArrays,
+                        const size_t offset) -> void {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            From sample;
+            std::memcpy(&sample, input + (i * numChannels + ch) * sizeof(From),
+                        sizeof(From));
+            sampleArrays[ch][offset + i] = convert_sample<From, To>(sample);
+        }
+    }
+}
+
+/**
+ * @brief Deinterleaves and converts samples from the sample format of a WAV
+ * file.
+ * @tparam T The type of the output samples
+ * @param input The input buffer, which must hold count * blockAlign bytes
+ * @param count The number of frames to decode
+ * @param config The configuration describing the input format
+ * @param sampleArrays The output samples, one array per channel
+ * @param offset The index in each output array of the first decoded frame
+ */
+template<AllowedAudioDataType T>
+auto decode_frames(const uint8_t *input, const size_t count,
+                   const WavFileConfiguration &config, T *const *sampleArrays,
+                   const size_t offset = 0) -> void {
+    const size_t numChannels = config.numChannels;
+    /// Float-32 input format
+    if (config.format == WavFormat::FLOAT) {
+        decode_interleaved<float, T>(input, count, numChannels, sampleArrays,
+                                     offset);
+        return;
+    }
+    switch (config.bitDepth) {
+        /// PCM-8 input format
+        case WavBitDepth::BIT_DEPTH_8: {
+            decode_interleaved<uint8_t, T>(input, count, numChannels,
+                                           sampleArrays, offset);
+            break;
+        }
+        /// PCM-16 input format
+        case WavBitDepth::BIT_DEPTH_16: {
+            decode_interleaved<int16_t, T>(input, count, numChannels,
+                                           sampleArrays, offset);
+            break;
+        }
+        /// PCM-24 input format
+        case WavBitDepth::BIT_DEPTH_24: {
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    const uint8_t *bytes = input + (i * numChannels + ch) * 3;
+                    /// Assemble the little-endian bytes and sign-extend
+                    const auto sample = static_cast<int32_t>(
+                            static_cast<uint32_t>(bytes[0]) << 8 |
+                            static_cast<uint32_t>(bytes[1]) << 16 |
+                            static_cast<uint32_t>(bytes[2]) << 24) >> 8;
+                    sampleArrays[ch][offset + i] =
+                            convert_sample_from_int24<T>(sample);
+                }
+            }
+            break;
+        }
+        /// PCM-32 input format
+        case WavBitDepth::BIT_DEPTH_32: {
+            decode_interleaved<int32_t, T>(input, count, numChannels,
+                                           sampleArrays, offset);
+            break;
+        }
+    }
+}
+
+#endif // WAV_CONVERSION_H
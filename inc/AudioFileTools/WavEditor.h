@@ -0,0 +1,181 @@
+/// WavEditor.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_EDITOR_H
+#define WAV_EDITOR_H
+
+#include <array>
+#include <cassert>
+#include <optional>
+#include <string>
+
+#include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavHeader.h"
+
+/**
+ * @brief WAV file editor class.
+ * @details The WAV file editor class overwrites regions of an existing WAV
+ * file in place. Only the pages covering the edited frames are mapped and
+ * written, so the cost of an edit scales with the size of the region rather
+ * than the size of the file. The header and the rest of the file are left
+ * untouched.
+ */
+class WavEditor {
+public:
+    /**
+     * @brief Public constructor that opens an existing WAV file for editing.
+     * @param filename The filename of the WAV file
+     * @return A WAV editor object if the file is a valid WAV file,
+     * std::nullopt otherwise
+     */
+    static auto create(const std::string &filename)
+            -> std::optional<WavEditor>;
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavEditor();
+
+    /**
+     * @brief Close the WAV file.
+     */
+    auto close_file() -> void;
+
+    /**
+     * @brief Gets the editor configuration.
+     * @return The editor configuration
+     */
+    auto get_configuration() -> WavFileConfiguration;
+
+    /**
+     * @brief Overwrites a range of frames with audio data, converting it to
+     * the sample format of the file.
+     * @param frame The index of the first frame to overwrite
+     * @param count Number of frames to overwrite
+     * @param samples Pointer to the first channel of audio data
+     * @param rest Other audio channels
+     * @return True if the frames were overwritten, false if the range lies
+     * outside the data chunk or could not be mapped
+     */
+    template<AllowedAudioDataType T, typename... Args>
+    auto overwrite(const size_t frame, const size_t count, const T *samples,
+                   Args... rest) -> bool {
+        /// Assemble input arrays into a single array
+        constexpr size_t num_arrays = sizeof...(rest) + 1;
+        assert(num_arrays == m_config.numChannels);
+        std::array<const T *, num_arrays> sampleArrays = {samples, rest...};
+        if (count == 0) {
+            return true;
+        }
+        uint8_t *region = map_frames(frame, count);
+        if (region == nullptr) {
+            return false;
+        }
+        encode_frames(sampleArrays.data(), count, m_config, region);
+        return unmap_frames();
+    }
+
+    /**
+     * @brief Overloaded move constructor
+     * @param other The other WAV editor object
+     */
+    WavEditor(WavEditor &&other) noexcept :
+        m_config(std::move(other.m_config)),
+        m_headerLayout(other.m_headerLayout),
+        m_fileDescriptor(other.m_fileDescriptor) {
+        other.m_fileDescriptor = -1;
+    }
+
+    /**
+     * @brief Overloaded move assignment operator
+     * @param other The other WAV editor object
+     * @return The WAV editor object
+     */
+    WavEditor &operator=(WavEditor &&other) noexcept {
+        if (this != &other) {
+            close_file();
+            m_config = std::move(other.m_config);
+            m_headerLayout = other.m_headerLayout;
+            m_fileDescriptor = other.m_fileDescriptor;
+            other.m_fileDescriptor = -1;
+        }
+        return *this;
+    }
+
+    /** Delete copy constructor and copy assignment operator */
+    WavEditor(const WavEditor &) = delete;
+    WavEditor &operator=(const WavEditor &) = delete;
+
+private:
+    /**
+     * @brief Private constructor
+     * @param filename The filename of the WAV file
+     */
+    explicit WavEditor(std::string filename) {
+        m_config.filename = std::move(filename);
+    }
+
+    /**
+     * @brief Opens the WAV file for reading and writing.
+     * @return True if the file was opened successfully, false otherwise
+     */
+    auto open_file() -> bool;
+
+    /**
+     * @brief Maps the pages covering a range of frames into memory.
+     * @param frame The index of the first frame
+     * @param count The number of frames
+     * @return A pointer to the first byte of the first frame, or nullptr if
+     * the range is invalid or could not be mapped
+     */
+    auto map_frames(size_t frame, size_t count) -> uint8_t *;
+
+    /**
+     * @brief Unmaps the pages mapped by map_frames().
+     * @details Write-back is only scheduled with MS_ASYNC, so the data may not
+     * be on disk when this returns.
+     * @return True if the pages were scheduled for write-back and unmapped,
+     * false otherwise
+     */
+    auto unmap_frames() -> bool;
+
+    /** The configuration for the WAV editor */
+    WavFileConfiguration m_config = {};
+
+    /** The offsets of the header fields */
+    WavHeaderLayout m_headerLayout = {};
+
+    /** The file descriptor for the WAV file */
+    int m_fileDescriptor = -1;
+
+    /** The start of the current mapping */
+    void *m_mapping = nullptr;
+
+    /** The length of the current mapping */
+    size_t m_mappingLength = 0;
+};
+
+#endif // WAV_EDITOR_H
@@ -0,0 +1,212 @@
+/// WavEdlReader.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_EDL_READER_H
+#define WAV_EDL_READER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavReader.h"
+
+/** A region of a source file placed on the timeline of an edit list */
+struct WavEdlRegion {
+    /** The filename of the source WAV file */
+    std::string filename;
+    /** The first frame of the region in the source file */
+    size_t sourceStart = 0;
+    /** The number of frames in the region */
+    size_t length = 0;
+    /** The linear gain applied to the region */
+    float gain = 1.0f;
+    /** The number of frames overlapping the end of the previous region, over
+     * which the two are crossfaded */
+    size_t crossfade = 0;
+};
+
+/**
+ * @brief Reads an edit decision list of regions as if it were one WAV file.
+ * @details Regions play one after another, each overlapping the previous one
+ * by its crossfade. Source files are opened the first time one of their
+ * regions is read and stay open, shared by every region of that file.
+ * Samples are read straight from the sources and mixed in float, so the
+ * composite is never written anywhere. A region whose source cannot be
+ * opened, or does not match the list's sample rate and channel count, plays
+ * as silence.
+ */
+class WavEdlReader {
+public:
+    /**
+     * @brief Public constructor that lays out the regions on the timeline.
+     * @param regions The regions, in playback order
+     * @param sampleRate The sample rate of every source
+     * @param numChannels The number of channels of every source
+     * @return An edit list reader object if the regions are valid,
+     * std::nullopt otherwise
+     */
+    static auto create(std::vector<WavEdlRegion> regions,
+                       WavSampleRate sampleRate, uint8_t numChannels)
+            -> std::optional<WavEdlReader>;
+
+    /**
+     * @brief Gets the configuration of the composite stream.
+     * @return The configuration, as 32-bit float with an empty filename
+     */
+    auto get_configuration() -> WavFileConfiguration;
+
+    /**
+     * @brief Gets the length of the timeline.
+     * @return The number of frames
+     */
+    [[nodiscard]] auto num_frames() const -> size_t;
+
+    /**
+     * @brief Gets the number of regions that played as silence because their
+     * source could not be used.
+     * @return The number of failed regions
+     */
+    [[nodiscard]] auto failed_regions() const -> size_t;
+
+    /**
+     * @brief Moves the position used by read() and read_into().
+     * @param frame The index of the next frame to read
+     * @return True if the frame is within the timeline, false otherwise
+     */
+    auto seek_frame(size_t frame) -> bool;
+
+    /**
+     * @brief Gets the position used by read() and read_into().
+     * @return The index of the next frame to read
+     */
+    [[nodiscard]] auto tell_frame() const -> size_t;
+
+    /**
+     * @brief Reads samples from the current position and advances it.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @return The samples, one vector per channel
+     */
+    template<AllowedAudioDataType T>
+    auto read(const size_t count) -> std::vector<std::vector<T>> {
+        std::vector<std::vector<T>> samples(m_config.numChannels,
+                                            std::vector<T>(count));
+        std::vector<T *> sampleArrays(m_config.numChannels);
+        for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+            sampleArrays[ch] = samples[ch].data();
+        }
+        const size_t framesRead = read_into(count, sampleArrays.data());
+        for (auto &channel : samples) {
+            channel.resize(framesRead);
+        }
+        return samples;
+    }
+
+    /**
+     * @brief Reads samples from the current position into caller-provided
+     * buffers and advances it.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @param sampleArrays The output samples, one array per channel, each
+     * holding at least count samples
+     * @return The number of frames read, which is less than count at the end
+     * of the timeline
+     */
+    template<AllowedAudioDataType T>
+    auto read_into(const size_t count, T *const *sampleArrays) -> size_t {
+        const size_t frames = mix(count);
+        for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+            for (size_t i = 0; i < frames; ++i) {
+                sampleArrays[ch][i] =
+                        convert_sample<float, T>(m_mix[ch][i]);
+            }
+        }
+        m_cursor += frames;
+        return frames;
+    }
+
+private:
+    /** A region and its place on the timeline */
+    struct PlacedRegion {
+        WavEdlRegion region;
+        /** The first frame of the region on the timeline */
+        size_t start = 0;
+        /** The number of frames at the end overlapped by the next region */
+        size_t fadeOut = 0;
+    };
+
+    /**
+     * @brief Private constructor
+     */
+    WavEdlReader() = default;
+
+    /**
+     * @brief Mixes the regions overlapping the next frames into the mix
+     * buffers.
+     * @param count The number of frames to mix
+     * @return The number of frames mixed
+     */
+    auto mix(size_t count) -> size_t;
+
+    /**
+     * @brief Gets the reader of a source file, opening it on first use.
+     * @param filename The filename of the source
+     * @return The reader, or nullptr if the source cannot be used
+     */
+    auto source(const std::string &filename) -> const WavReader *;
+
+    /** The configuration of the composite stream */
+    WavFileConfiguration m_config = {};
+
+    /** The regions, in timeline order */
+    std::vector<PlacedRegion> m_regions;
+
+    /** The source readers by filename, std::nullopt for unusable sources */
+    std::unordered_map<std::string, std::optional<WavReader>> m_sources;
+
+    /** The regions whose source could not be used */
+    std::vector<bool> m_failed;
+
+    /** The length of the timeline */
+    size_t m_numFrames = 0;
+
+    /** The index of the next frame returned by read() */
+    size_t m_cursor = 0;
+
+    /** The mixed samples of the current read, one vector per channel */
+    std::vector<std::vector<float>> m_mix;
+
+    /** The samples read from a source, one vector per channel */
+    std::vector<std::vector<float>> m_scratch;
+
+    /** Pointers to the scratch vectors */
+    std::vector<float *> m_scratchArrays;
+};
+
+#endif // WAV_EDL_READER_H
@@ -0,0 +1,313 @@
+/// WavGraph.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_GRAPH_H
+#define WAV_GRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "WavReader.h"
+#include "WavWriter.h"
+
+/**
+ * @brief Fixed-size block of planar float samples passed between nodes.
+ * @details The samples of all channels live in one allocation made when the
+ * block is created, so running a graph does not allocate.
+ */
+class WavBlock {
+public:
+    /**
+     * @brief Public constructor that allocates the samples.
+     * @param numChannels The number of channels
+     * @param capacity The number of frames the block can hold
+     */
+    WavBlock(size_t numChannels, size_t capacity);
+
+    /** Delete copy constructor and copy assignment operator, since a copy
+     * would keep pointing at the source's samples */
+    WavBlock(const WavBlock &) = delete;
+    WavBlock &operator=(const WavBlock &) = delete;
+
+    /** Default move constructor and move assignment operator, which keep
+     * the samples in place */
+    WavBlock(WavBlock &&) noexcept = default;
+    WavBlock &operator=(WavBlock &&) noexcept = default;
+
+    /**
+     * @brief Gets the samples of a channel.
+     * @param ch The index of the channel
+     * @return Pointer to capacity() samples
+     */
+    auto channel(const size_t ch) -> float * { return m_channels[ch]; }
+
+    /**
+     * @brief Gets the samples of every channel.
+     * @return One pointer per channel
+     */
+    auto channels() -> float *const * { return m_channels.data(); }
+
+    /**
+     * @brief Gets the number of channels.
+     * @return The number of channels
+     */
+    [[nodiscard]] auto num_channels() const -> size_t {
+        return m_channels.size();
+    }
+
+    /**
+     * @brief Gets the number of frames the block can hold.
+     * @return The capacity in frames
+     */
+    [[nodiscard]] auto capacity() const -> size_t { return m_capacity; }
+
+private:
+    /** The samples, channel after channel */
+    std::vector<float> m_samples;
+
+    /** Pointers to the start of each channel */
+    std::vector<float *> m_channels;
+
+    /** The number of frames the block can hold */
+    size_t m_capacity;
+};
+
+/**
+ * @brief Node of a pull-based processing graph.
+ * @details A node fills a block when it is pulled, pulling its upstream
+ * node first if it has one. Blocks flow through the graph in place, so a
+ * chain of nodes shares a single block.
+ */
+class WavGraphNode {
+public:
+    /**
+     * @brief Public destructor
+     */
+    virtual ~WavGraphNode() = default;
+
+    /**
+     * @brief Produces the next block of samples.
+     * @param block The block to fill, with num_channels() channels
+     * @return The number of frames produced, 0 once the stream has ended
+     */
+    virtual auto pull(WavBlock &block) -> size_t = 0;
+
+    /**
+     * @brief Gets the number of channels produced by the node.
+     * @return The number of channels
+     */
+    [[nodiscard]] virtual auto num_channels() const -> size_t = 0;
+};
+
+/**
+ * @brief Source node reading a WAV file.
+ */
+class WavReaderSource final : public WavGraphNode {
+public:
+    /**
+     * @brief Public constructor
+     * @param reader The reader, read from its current position
+     */
+    explicit WavReaderSource(WavReader reader);
+
+    /**
+     * @brief Reads the next block from the file.
+     * @param block The block to fill
+     * @return The number of frames read
+     */
+    auto pull(WavBlock &block) -> size_t override;
+
+    /**
+     * @brief Gets the number of channels of the file.
+     * @return The number of channels
+     */
+    [[nodiscard]] auto num_channels() const -> size_t override;
+
+private:
+    /** The reader */
+    WavReader m_reader;
+
+    /** The number of channels of the file */
+    size_t m_numChannels;
+};
+
+/**
+ * @brief Node applying a chain of elementwise operations in a single pass.
+ * @details Each operation is called as op(sample, channel) and returns the
+ * processed sample. All operations run on a sample before moving to the
+ * next, so adding a stage adds arithmetic but no extra pass over memory and
+ * no extra buffer. fuse() merges adjacent elementwise stages into one node
+ * at compile time.
+ * @tparam Ops The types of the operations, in order
+ */
+template<typename... Ops>
+class WavElementwiseNode final : public WavGraphNode {
+public:
+    /**
+     * @brief Public constructor
+     * @param upstream The node providing the samples, which must outlive
+     * this node
+     * @param ops The operations
+     */
+    explicit WavElementwiseNode(WavGraphNode &upstream, Ops... ops) :
+        m_upstream(&upstream), m_ops(std::move(ops)...) {}
+
+    /**
+     * @brief Constructor from an existing chain of operations
+     * @param upstream The node providing the samples
+     * @param ops The operations
+     */
+    WavElementwiseNode(WavGraphNode &upstream, std::tuple<Ops...> ops) :
+        m_upstream(&upstream), m_ops(std::move(ops)) {}
+
+    /**
+     * @brief Pulls a block from upstream and processes it in place.
+     * @param block The block to fill
+     * @return The number of frames produced
+     */
+    auto pull(WavBlock &block) -> size_t override {
+        const size_t frames = m_upstream->pull(block);
+        for (size_t ch = 0; ch < block.num_channels(); ++ch) {
+            float *samples = block.channel(ch);
+            for (size_t i = 0; i < frames; ++i) {
+                samples[i] = std::apply(
+                        [&](auto &...op) {
+                            float sample = samples[i];
+                            ((sample = op(sample, ch)), ...);
+                            return sample;
+                        },
+                        m_ops);
+            }
+        }
+        return frames;
+    }
+
+    /**
+     * @brief Gets the number of channels produced by the node.
+     * @return The number of channels of the upstream node
+     */
+    [[nodiscard]] auto num_channels() const -> size_t override {
+        return m_upstream->num_channels();
+    }
+
+    /**
+     * @brief Gets one of the operations, e.g. to read a meter.
+     * @tparam I The index of the operation
+     * @return The operation
+     */
+    template<size_t I>
+    auto op() -> auto & {
+        return std::get<I>(m_ops);
+    }
+
+    /**
+     * @brief Gets the upstream node.
+     * @return The upstream node
+     */
+    auto upstream() -> WavGraphNode & { return *m_upstream; }
+
+    /**
+     * @brief Releases the operations, to fuse them into another node.
+     * @return The operations
+     */
+    auto take_ops() -> std::tuple<Ops...> { return std::move(m_ops); }
+
+private:
+    /** The node providing the samples */
+    WavGraphNode *m_upstream;
+
+    /** The operations */
+    std::tuple<Ops...> m_ops;
+};
+
+/**
+ * @brief Creates a node applying elementwise operations to a node's output.
+ * @param upstream The node providing the samples
+ * @param ops The operations
+ * @return The elementwise node
+ */
+template<typename... Ops>
+auto fuse(WavGraphNode &upstream, Ops... ops) -> WavElementwiseNode<Ops...> {
+    return WavElementwiseNode<Ops...>(upstream, std::move(ops)...);
+}
+
+/**
+ * @brief Appends elementwise operations to an elementwise node, fusing them
+ * into a single node.
+ * @param node The elementwise node, which is consumed
+ * @param ops The operations to append
+ * @return The fused node, pulling from the same upstream node
+ */
+template<typename... Ops, typename... More>
+auto fuse(WavElementwiseNode<Ops...> &&node, More... ops)
+        -> WavElementwiseNode<Ops..., More...> {
+    return WavElementwiseNode<Ops..., More...>(
+            node.upstream(),
+            std::tuple_cat(node.take_ops(), std::make_tuple(std::move(ops)...)));
+}
+
+/** Elementwise operation applying a linear gain */
+struct WavGain {
+    float gain = 1.0f;
+    auto operator()(const float sample, size_t) const -> float {
+        return sample * gain;
+    }
+};
+
+/** Elementwise operation clipping samples to [-limit, limit] */
+struct WavClip {
+    float limit = 1.0f;
+    auto operator()(const float sample, size_t) const -> float {
+        return std::clamp(sample, -limit, limit);
+    }
+};
+
+/** Elementwise operation recording the peak level of each channel */
+struct WavPeakMeter {
+    std::array<float, UINT8_MAX> peaks{};
+    auto operator()(const float sample, const size_t ch) -> float {
+        peaks[ch] = std::max(peaks[ch], std::abs(sample));
+        return sample;
+    }
+};
+
+/**
+ * @brief Pulls every block out of a graph and writes it to a WAV file.
+ * @details One block is allocated up front and reused for the whole run.
+ * @param node The last node of the graph
+ * @param writer The writer, with as many channels as the node
+ * @param blockFrames The number of frames per block
+ * @return The number of frames written, 0 if the writer and the node have
+ * different channel counts
+ */
+auto run_graph(WavGraphNode &node, WavWriter &writer, size_t blockFrames)
+        -> uint64_t;
+
+#endif // WAV_GRAPH_H
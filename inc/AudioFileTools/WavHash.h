@@ -0,0 +1,102 @@
+/// WavHash.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_HASH_H
+#define WAV_HASH_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/** The ID of the chunk holding the hash of the data chunk payload */
+inline constexpr char kWavHashChunkId[4] = {'x', 'h', '6', '4'};
+
+/**
+ * @brief Incremental XXH64 hasher.
+ * @details Produces the same digest as XXH64 over the concatenation of all
+ * the bytes passed to update(), however they are split. Hashing runs at
+ * memory bandwidth, so it can be kept on the I/O path.
+ */
+class WavHasher {
+public:
+    /**
+     * @brief Public constructor
+     * @param seed The seed of the hash
+     */
+    explicit WavHasher(uint64_t seed = 0);
+
+    /**
+     * @brief Adds bytes to the hash.
+     * @param data The bytes
+     * @param byteCount The number of bytes
+     */
+    auto update(const void *data, size_t byteCount) -> void;
+
+    /**
+     * @brief Gets the hash of the bytes added so far.
+     * @return The digest
+     */
+    [[nodiscard]] auto digest() const -> uint64_t;
+
+    /**
+     * @brief Restarts the hash.
+     */
+    auto reset() -> void;
+
+private:
+    /** The seed of the hash */
+    uint64_t m_seed;
+
+    /** The four accumulators */
+    std::array<uint64_t, 4> m_accumulators{};
+
+    /** The bytes of an incomplete 32-byte stripe */
+    std::array<uint8_t, 32> m_buffer{};
+
+    /** The number of bytes in the buffer */
+    size_t m_buffered = 0;
+
+    /** The total number of bytes added */
+    uint64_t m_totalBytes = 0;
+};
+
+/**
+ * @brief Reads the payload hash stored in a WAV file by WavWriter.
+ * @param filename The filename of the WAV file
+ * @return The stored digest, or std::nullopt if the file has none
+ */
+auto read_wav_stored_hash(const std::string &filename)
+        -> std::optional<uint64_t>;
+
+/**
+ * @brief Hashes the data chunk payload of a WAV file.
+ * @param filename The filename of the WAV file
+ * @return The digest, or std::nullopt if the file is not a valid WAV file or
+ * its data chunk is truncated
+ */
+auto hash_wav_payload(const std::string &filename) -> std::optional<uint64_t>;
+
+#endif // WAV_HASH_H
@@ -0,0 +1,58 @@
+/// WavHeader.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_HEADER_H
+#define WAV_HEADER_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+
+#include "WavConfiguration.h"
+
+/** Offsets of the WAV header fields located while parsing a file */
+struct WavHeaderLayout {
+    /** Offset of the RIFF chunk size field */
+    uint64_t riffSizeOffset = 4;
+    /** Offset of the data chunk size field */
+    uint64_t dataSizeOffset = 40;
+    /** Offset of the first byte of the data chunk payload */
+    uint64_t dataOffset = 44;
+};
+
+/**
+ * @brief Reads a WAV file header from a stream and verifies that the
+ * configuration is supported.
+ * @details On success the stream is left positioned at the start of the data
+ * chunk payload. Only the fields read from the file are assigned to the
+ * configuration, so the filename is left untouched.
+ * @param stream The stream to read, positioned at the start of the file
+ * @param config The configuration to fill in
+ * @return The header layout if the header is valid, std::nullopt otherwise
+ */
+auto read_wav_header(std::istream &stream, WavFileConfiguration &config)
+        -> std::optional<WavHeaderLayout>;
+
+#endif // WAV_HEADER_H
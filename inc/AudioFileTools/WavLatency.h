@@ -0,0 +1,188 @@
+/// WavLatency.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef WAV_LATENCY_H
+#define WAV_LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "WavConfiguration.h"
+
+/** A summary of the call latencies of a WAV reader or writer */
+struct WavLatencySummary {
+    /** The number of calls recorded */
+    uint64_t count = 0;
+    /** The number of calls that took longer than the deadline */
+    uint64_t deadlineMisses = 0;
+    /** The median latency, in nanoseconds */
+    uint64_t p50 = 0;
+    /** The 99th percentile latency, in nanoseconds */
+    uint64_t p99 = 0;
+    /** The 99.9th percentile latency, in nanoseconds */
+    uint64_t p999 = 0;
+    /** The largest latency, in nanoseconds */
+    uint64_t max = 0;
+};
+
+/**
+ * @brief Log-linear latency histogram with deadline-miss accounting.
+ * @details Like an HDR histogram, each power of two is split into 32 equal
+ * buckets, so percentiles are within about 3% of the real value, from
+ * nanoseconds up to hours, in a fixed 10 KiB. Recording is a few relaxed
+ * atomic increments and never allocates, so it can run on an audio thread
+ * while another thread reads the summary.
+ */
+class WavLatencyHistogram {
+public:
+    /**
+     * @brief Public constructor
+     * @param deadlineNanoseconds The deadline, or 0 for none
+     */
+    explicit WavLatencyHistogram(uint64_t deadlineNanoseconds = 0);
+
+    /**
+     * @brief Records one latency.
+     * @param nanoseconds The latency
+     */
+    auto record(uint64_t nanoseconds) -> void;
+
+    /**
+     * @brief Gets the latency at a given percentile.
+     * @param percentile The percentile, between 0 and 100
+     * @return The highest latency in the bucket holding the percentile, or 0
+     * if nothing was recorded
+     */
+    [[nodiscard]] auto percentile(double percentile) const -> uint64_t;
+
+    /**
+     * @brief Gets the count, deadline misses and main percentiles.
+     * @return The summary
+     */
+    [[nodiscard]] auto summary() const -> WavLatencySummary;
+
+    /**
+     * @brief Gets the deadline.
+     * @return The deadline in nanoseconds, or 0 for none
+     */
+    [[nodiscard]] auto deadline() const -> uint64_t;
+
+    /**
+     * @brief Forgets every recorded latency.
+     */
+    auto reset() -> void;
+
+private:
+    /** The number of buckets for each power of two */
+    static constexpr unsigned kSubBuckets = 32;
+
+    /** The number of buckets, covering latencies up to 2^44 ns */
+    static constexpr size_t kBuckets = 2 * kSubBuckets + 38 * kSubBuckets;
+
+    /**
+     * @brief Gets the bucket of a latency.
+     * @param nanoseconds The latency
+     * @return The index of the bucket
+     */
+    static auto bucket_index(uint64_t nanoseconds) -> size_t;
+
+    /**
+     * @brief Gets the highest latency counted in a bucket.
+     * @param index The index of the bucket
+     * @return The latency in nanoseconds
+     */
+    static auto bucket_upper(size_t index) -> uint64_t;
+
+    /** The deadline, or 0 for none */
+    uint64_t m_deadline;
+
+    /** The number of latencies in each bucket */
+    std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};
+
+    /** The number of latencies recorded */
+    std::atomic<uint64_t> m_count{0};
+
+    /** The number of latencies over the deadline */
+    std::atomic<uint64_t> m_misses{0};
+
+    /** The largest latency */
+    std::atomic<uint64_t> m_max{0};
+};
+
+/**
+ * @brief Records the time until it goes out of scope in a histogram.
+ * @details Does nothing, and does not read the clock, when the histogram is
+ * null.
+ */
+class WavLatencyTimer {
+public:
+    /**
+     * @brief Public constructor
+     * @param histogram The histogram, or nullptr
+     */
+    explicit WavLatencyTimer(WavLatencyHistogram *histogram) :
+        m_histogram(histogram) {
+        if (m_histogram != nullptr) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavLatencyTimer() {
+        if (m_histogram != nullptr) {
+            m_histogram->record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - m_start)
+                            .count()));
+        }
+    }
+
+    /** Delete copy constructor and copy assignment operator */
+    WavLatencyTimer(const WavLatencyTimer &) = delete;
+    WavLatencyTimer &operator=(const WavLatencyTimer &) = delete;
+
+private:
+    /** The histogram */
+    WavLatencyHistogram *m_histogram;
+
+    /** The time the timer was created */
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Gets the duration of a block of frames at the sample rate of a
+ * configuration, which is the natural deadline for reading or writing it in
+ * real time.
+ * @param config The configuration
+ * @param frames The number of frames per block
+ * @return The duration in nanoseconds
+ */
+auto wav_block_period(const WavFileConfiguration &config, size_t frames)
+        -> uint64_t;
+
+#endif // WAV_LATENCY_H
@@ -0,0 +1,93 @@
+/// WavMixer.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_MIXER_H
+#define WAV_MIXER_H
+
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+#include "WavThreadPool.h"
+
+/** A source of a mixdown */
+struct WavMixerSource {
+    /** The filename of the source WAV file */
+    std::string filename;
+    /** The linear gain applied to the source */
+    float gain = 1.0f;
+    /** The position from -1 (left) to 1 (right), used for stereo output */
+    float pan = 0.0f;
+};
+
+/** Options for a mixdown */
+struct WavMixerOptions {
+    /** The number of worker threads, or 0 to use one per hardware thread */
+    size_t numThreads = 0;
+    /** The number of frames mixed by each task */
+    size_t blockFrames = 8192;
+};
+
+/**
+ * @brief Mixes many WAV files down into one.
+ * @details The timeline is cut into blocks that are mixed in parallel, each
+ * worker reading its time range of every source and accumulating it into a
+ * float bus. Finished blocks are written in order through a WavWriter while
+ * the next ones are mixed.
+ *
+ * Mono sources are placed on a stereo output with a constant-power pan law,
+ * and the pan of a stereo source balances its two channels. Stereo sources
+ * are averaged into a mono output. Any other source must have as many
+ * channels as the output, and is mixed channel by channel.
+ */
+class WavMixer {
+public:
+    /**
+     * @brief Public constructor that starts the worker threads.
+     * @param options The mixdown options
+     */
+    explicit WavMixer(WavMixerOptions options = {});
+
+    /**
+     * @brief Mixes the sources into a new WAV file.
+     * @details The sources must have the sample rate of the output. The
+     * output is as long as the longest source.
+     * @param sources The sources
+     * @param output The configuration of the output file
+     * @return True if every source was mixed and the output written, false
+     * otherwise
+     */
+    auto render(const std::vector<WavMixerSource> &sources,
+                const WavFileConfiguration &output) -> bool;
+
+private:
+    /** The mixdown options */
+    WavMixerOptions m_options;
+
+    /** The pool mixing the blocks */
+    WavThreadPool m_pool;
+};
+
+#endif // WAV_MIXER_H
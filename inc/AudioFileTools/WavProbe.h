@@ -0,0 +1,75 @@
+/// WavProbe.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_PROBE_H
+#define WAV_PROBE_H
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+
+/** Options for probing WAV file headers */
+struct WavProbeOptions {
+    /** The number of files kept in flight */
+    size_t queueDepth = 256;
+    /** The number of bytes read from the start of each file. Headers that do
+     * not fit are parsed again from the file */
+    size_t headerBytes = 4096;
+    /** Whether to use io_uring when the kernel supports it */
+    bool useIoUring = true;
+};
+
+/**
+ * @brief Callback receiving the result of probing one file.
+ * @param index The index of the file in the list of filenames
+ * @param config The configuration of the file, or std::nullopt if the file
+ * could not be opened or is not a valid WAV file
+ */
+using WavProbeCallback =
+        std::function<void(size_t index,
+                           const std::optional<WavFileConfiguration> &config)>;
+
+/**
+ * @brief Reads and parses the headers of many WAV files.
+ * @details With io_uring, the open, read and close of up to queueDepth files
+ * are kept in flight at once, so probing is not bound by the latency of each
+ * system call. Kernels without io_uring, or without support for the needed
+ * operations, fall back to probing the files one at a time. Either way the
+ * callback is invoked on the calling thread, once per file, in completion
+ * order.
+ * @param filenames The filenames of the WAV files
+ * @param callback The callback receiving the result for each file
+ * @param options The probing options
+ * @return True if io_uring was used, false if the synchronous fallback was
+ * used
+ */
+auto probe_wav_headers(const std::vector<std::string> &filenames,
+                       const WavProbeCallback &callback,
+                       const WavProbeOptions &options = {}) -> bool;
+
+#endif // WAV_PROBE_H
@@ -25,16 +25,60 @@ SOFTWARE.
 #ifndef WAV_READER_H
 #define WAV_READER_H
 
-#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavHash.h"
+#include "WavHeader.h"
+#include "WavLatency.h"
+#include "WavRealtime.h"
+#include "WavStats.h"
+#include "WavTrace.h"
 #include "WavUtils.h"
 
+template<AllowedAudioDataType T>
+class WavBlockView;
+
+/** Page cache hints and I/O mode for a WAV reader */
+struct WavReaderOptions {
+    /** Tell the kernel the file is read from start to end, so it reads
+     * ahead aggressively */
+    bool sequential = false;
+    /** The number of bytes past each read() that the kernel is asked to
+     * prefetch, or 0 to leave read-ahead to the kernel */
+    size_t readAheadBytes = 0;
+    /** Drop the pages behind read() from the page cache, so a single pass
+     * over a file does not evict other data */
+    bool dropBehind = false;
+    /** Bypass the page cache with O_DIRECT, through aligned buffers. Falls
+     * back to buffered reads when the file system does not support it */
+    bool directIo = false;
+    /** Count the data moved and time spent by the reader, see
+     * WavReader::get_stats() */
+    bool collectStats = false;
+    /** Record the latency of each read_into() call, see
+     * WavReader::get_latency() */
+    bool trackLatency = false;
+    /** The latency over which a read_into() call counts as a deadline miss,
+     * for example wav_block_period() of the block size, or 0 for none */
+    uint64_t deadlineNanoseconds = 0;
+};
+
 /**
  * @brief WAV file reader class.
- * @details The WAV file reader class reads audio data from a WAV file.
+ * @details The WAV file reader class reads audio data from a WAV file. All
+ * reads are positional, so read_at() can be called concurrently from many
+ * threads sharing one reader, while read() advances the reader's own cursor.
  */
 class WavReader {
 public:
@@ -42,10 +86,59 @@ public:
      * @brief Public constructor that verifies the configuration and creates a
      * WAV file reader object.
      * @param filename The filename of the WAV file
+     * @param options The page cache hints and I/O mode
      * @return A WAV reader object if the configuration is valid, std::nullopt
      * otherwise
      */
-    static auto create(const std::string &filename) -> std::optional<WavReader>;
+    static auto create(const std::string &filename,
+                       WavReaderOptions options = {})
+            -> std::optional<WavReader>;
+
+    /**
+     * @brief Checks whether reads bypass the page cache.
+     * @return True if the file was opened with O_DIRECT, false otherwise
+     */
+    [[nodiscard]] auto is_direct_io() const -> bool;
+
+    /**
+     * @brief Gets the hash of the data chunk payload, computed as read()
+     * goes through the file.
+     * @details Reading from the start of the file to the end with read(),
+     * read_into() or blocks() hashes the payload at no extra I/O. Seeking
+     * back to frame 0 restarts the hash.
+     * @return The XXH64 digest of the payload, or std::nullopt if read()
+     * has not read the whole payload in order
+     */
+    [[nodiscard]] auto get_payload_hash() const -> std::optional<uint64_t>;
+
+    /**
+     * @brief Gets the statistics collected since the reader was opened or
+     * the statistics were reset.
+     * @details Only collected when WavReaderOptions::collectStats is set and
+     * AUDIO_FILE_TOOLS_STATS is not 0.
+     * @return The statistics, all zero when they are not collected
+     */
+    [[nodiscard]] auto get_stats() const -> WavIoStats;
+
+    /**
+     * @brief Sets the statistics back to zero.
+     */
+    auto reset_stats() -> void;
+
+    /**
+     * @brief Gets the latencies of read_into() calls recorded since the reader was
+     * opened or the latencies were reset.
+     * @details Only recorded when WavReaderOptions::trackLatency is set. Can
+     * be called from another thread while the reader is in use.
+     * @return The count, deadline misses and percentiles, all zero when
+     * latencies are not recorded
+     */
+    [[nodiscard]] auto get_latency() const -> WavLatencySummary;
+
+    /**
+     * @brief Forgets the recorded latencies.
+     */
+    auto reset_latency() -> void;
 
     /**
      * @brief Public destructor
@@ -63,13 +156,47 @@ public:
      */
     auto get_configuration() -> WavFileConfiguration;
 
+    /**
+     * @brief Moves the position used by read() and read_into().
+     * @param frame The index of the next frame to read
+     * @return True if the frame is within the data chunk, false otherwise
+     */
+    auto seek_frame(size_t frame) -> bool;
+
+    /**
+     * @brief Gets the position used by read() and read_into().
+     * @return The index of the next frame to read
+     */
+    [[nodiscard]] auto tell_frame() const -> size_t;
+
+    /**
+     * @brief Asks the kernel to start reading a range of frames into the page
+     * cache, without waiting for it.
+     * @param frame The index of the first frame
+     * @param count The number of frames
+     */
+    auto prefetch(size_t frame, size_t count) const -> void;
+
     /**
      * @brief Overloaded move constructor
      * @param other The other WAV reader object
      */
     WavReader(WavReader &&other) noexcept :
         m_config(std::move(other.m_config)),
-        m_fileStream(std::move(other.m_fileStream)) {}
+        m_headerLayout(other.m_headerLayout),
+        m_fileDescriptor(other.m_fileDescriptor),
+        m_cursor(other.m_cursor),
+        m_readBuffer(std::move(other.m_readBuffer)),
+        m_directBuffer(std::move(other.m_directBuffer)),
+        m_options(other.m_options),
+        m_directIo(other.m_directIo),
+        m_droppedUntil(other.m_droppedUntil),
+        m_hasher(other.m_hasher),
+        m_hashedFrames(other.m_hashedFrames),
+        m_stats(std::move(other.m_stats)),
+        m_latency(std::move(other.m_latency)) {
+        other.m_fileDescriptor = -1;
+    }
 
     /**
      * @brief Overloaded move assignment operator
@@ -78,8 +205,21 @@ public:
      */
     WavReader &operator=(WavReader &&other) noexcept {
         if (this != &other) {
+            close_file();
             m_config = std::move(other.m_config);
-            m_fileStream = std::move(other.m_fileStream);
+            m_headerLayout = other.m_headerLayout;
+            m_fileDescriptor = other.m_fileDescriptor;
+            m_cursor = other.m_cursor;
+            m_readBuffer = std::move(other.m_readBuffer);
+            m_directBuffer = std::move(other.m_directBuffer);
+            m_options = other.m_options;
+            m_directIo = other.m_directIo;
+            m_droppedUntil = other.m_droppedUntil;
+            m_hasher = other.m_hasher;
+            m_hashedFrames = other.m_hashedFrames;
+            m_stats = std::move(other.m_stats);
+            m_latency = std::move(other.m_latency);
+            other.m_fileDescriptor = -1;
         }
         return *this;
     }
@@ -88,177 +228,328 @@ public:
     WavReader(const WavReader &) = delete;
     WavReader &operator=(const WavReader &) = delete;
 
+    /**
+     * @brief Reads samples from the current position and advances it.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @return The samples, one vector per channel, holding fewer than count
+     * frames at the end of the data chunk
+     */
     template<AllowedAudioDataType T>
     auto read(const size_t count) -> std::vector<std::vector<T>> {
-        if (m_config.format == WavFormat::FLOAT) {
-            auto samples = read_samples<float>(count);
-            if constexpr (std::same_as<T, float>)
-                return samples;
-            if constexpr (std::same_as<T, uint8_t>)
-                return convert_samples<float, uint8_t>(samples,
-                                                       convert_float_to_uint8);
-            if constexpr (std::same_as<T, int16_t>)
-                return convert_samples<float, int16_t>(samples,
-                                                       convert_float_to_int16);
-            if constexpr (std::same_as<T, int32_t>)
-                return convert_samples<float, int32_t>(samples,
-                                                       convert_float_to_int32);
-        } else if (m_config.format == WavFormat::PCM) {
-            switch (m_config.bitDepth) {
-                case WavBitDepth::BIT_DEPTH_8: {
-                    auto samples = read_samples<uint8_t>(count);
-                    if constexpr (std::same_as<T, float>)
-                        return convert_samples<uint8_t, float>(
-                                samples, convert_uint8_to_float);
-                    if constexpr (std::same_as<T, uint8_t>)
-                        return samples;
-                    if constexpr (std::same_as<T, int16_t>)
-                        return convert_samples<uint8_t, int16_t>(
-                                samples, convert_uint8_to_int16);
-                    if constexpr (std::same_as<T, int32_t>)
-                        return convert_samples<uint8_t, int32_t>(
-                                samples, convert_uint8_to_int32);
-                    break;
-                }
-                case WavBitDepth::BIT_DEPTH_16: {
-                    auto samples = read_samples<int16_t>(count);
-                    if constexpr (std::same_as<T, float>)
-                        return convert_samples<int16_t, float>(
-                                samples, convert_int16_to_float);
-                    if constexpr (std::same_as<T, uint8_t>)
-                        return convert_samples<int16_t, uint8_t>(
-                                samples, convert_int16_to_uint8);
-                    if constexpr (std::same_as<T, int16_t>)
-                        return samples;
-                    if constexpr (std::same_as<T, int32_t>)
-                        return convert_samples<int16_t, int32_t>(
-                                samples, convert_int16_to_int32);
-                    break;
-                }
-                case WavBitDepth::BIT_DEPTH_24: {
-                    /// TODO - clean this up
-                    const auto interleavedSamples =
-                            read_raw_samples(count * m_config.numChannels * 3);
-                    std::vector<std::vector<int32_t>> samples(
-                            m_config.numChannels, std::vector<int32_t>(count));
-                    for (size_t i = 0; i < count; ++i) {
-                        for (size_t j = 0; j < m_config.numChannels; ++j) {
-                            const int32_t sample =
-                                    (interleavedSamples
-                                             [(i * m_config.numChannels + j) *
-                                              3] &
-                                     0xFF) |
-                                    ((interleavedSamples
-                                              [(i * m_config.numChannels + j) *
-                                                       3 +
-                                               1] &
-                                      0xFF)
-                                     << 8) |
-                                    ((interleavedSamples
-                                              [(i * m_config.numChannels + j) *
-                                                       3 +
-                                               2] &
-                                      0xFF)
-                                     << 16);
-                            samples[j][i] =
-                                    (sample & 0x800000)
-                                            ? static_cast<int32_t>(sample |
-                                                                   0xFF000000)
-                                            : sample;
-                        }
-                    }
-                    return convert_samples<int32_t, T>(samples,
-                                                       convert_int32_to_float);
-                }
-                case WavBitDepth::BIT_DEPTH_32: {
-                    auto samples = read_samples<int32_t>(count);
-                    if constexpr (std::same_as<T, float>)
-                        return convert_samples<int32_t, float>(
-                                samples, convert_int32_to_float);
-                    if constexpr (std::same_as<T, uint8_t>)
-                        return convert_samples<int32_t, uint8_t>(
-                                samples, convert_int32_to_uint8);
-                    if constexpr (std::same_as<T, int16_t>)
-                        return convert_samples<int32_t, int16_t>(
-                                samples, convert_int32_to_int16);
-                    if constexpr (std::same_as<T, int32_t>)
-                        return samples;
-                    break;
-                }
-            }
+        std::vector<std::vector<T>> samples(m_config.numChannels,
+                                            std::vector<T>(count));
+        std::vector<T *> sampleArrays(m_config.numChannels);
+        if (m_stats) {
+            m_stats->add_allocations(m_config.numChannels + 2);
+        }
+        for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+            sampleArrays[ch] = samples[ch].data();
         }
-        return {};
+        const size_t framesRead = read_into(count, sampleArrays.data());
+        for (auto &channel : samples) {
+            channel.resize(framesRead);
+        }
+        return samples;
     }
 
-private:
     /**
-     * @brief Private constructor
-     * @param filename The filename of the WAV file
+     * @brief Reads samples from the current position into caller-provided
+     * buffers and advances it.
+     * @details The raw read buffer is kept by the reader, so once it has
+     * grown to the block size, reading does not allocate.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @param sampleArrays The output samples, one array per channel, each
+     * holding at least count samples
+     * @return The number of frames read, which is less than count at the end
+     * of the data chunk
      */
-    explicit WavReader(std::string filename) {
-        m_config.filename = std::move(filename);
+    template<AllowedAudioDataType T>
+    auto read_into(const size_t count, T *const *sampleArrays) -> size_t {
+        WAV_REALTIME_SCOPE();
+        const WavLatencyTimer latencyTimer(m_latency.get());
+        /// Hash the payload while it is read in order from the start
+        const bool hashing = m_cursor == m_hashedFrames;
+        const size_t framesRead =
+                read_frames(m_cursor, count, sampleArrays, m_readBuffer,
+                            m_directBuffer,
+                            hashing ? &m_hasher : nullptr);
+        m_cursor += framesRead;
+        if (hashing) {
+            m_hashedFrames = m_cursor;
+        }
+        advise_consumed();
+        return framesRead;
     }
 
-    template<typename From, typename To, typename Converter>
-    std::vector<std::vector<To>>
-    convert_samples(const std::vector<std::vector<From>> &input,
-                    Converter converter) {
+    /**
+     * @brief Gets a view that reads the rest of the file in blocks.
+     * @details Iterating the view reads successive blocks from the current
+     * position into a single buffer owned by the view, and yields one span
+     * per channel for each block. The last block may be shorter than the
+     * block size. The view is an input range, so it composes with the
+     * std::views adaptors.
+     * @tparam T The type to convert the samples to
+     * @param frames The number of frames per block
+     * @return The block view
+     */
+    template<AllowedAudioDataType T>
+    auto blocks(size_t frames) -> WavBlockView<T>;
 
-        size_t numChannels = input.size();
-        size_t count = input[0].size();
-        std::vector<std::vector<To>> output(numChannels,
-                                            std::vector<To>(count));
+    /**
+     * @brief Reads samples from a given position without moving the reader's
+     * cursor.
+     * @details This function does not modify the reader and uses positional
+     * reads, so any number of threads can call it concurrently on the same
+     * reader. Each calling thread keeps its raw buffers, at most about 1 MiB,
+     * so reading block after block does not allocate.
+     * @tparam T The type to convert the samples to
+     * @param frame The index of the first frame to read
+     * @param count The number of frames to read
+     * @param sampleArrays The output samples, one array per channel, each
+     * holding at least count samples
+     * @return The number of frames read, which is less than count at the end
+     * of the data chunk
+     */
+    template<AllowedAudioDataType T>
+    auto read_at(const size_t frame, const size_t count,
+                 T *const *sampleArrays) const -> size_t {
+        /// The reader is shared between threads here, so each thread keeps
+        /// its own raw and O_DIRECT buffers
+        thread_local std::vector<uint8_t> raw;
+        thread_local AlignedBuffer directBuffer;
+        return read_frames(frame, count, sampleArrays, raw, directBuffer);
+    }
 
-        for (size_t i = 0; i < count; ++i) {
-            for (size_t j = 0; j < numChannels; ++j) {
-                output[j][i] = converter(input[j][i]);
-            }
+    /**
+     * @brief Reads the whole data chunk, decoding frame-aligned ranges on
+     * several threads straight into the returned buffer.
+     * @details The reader's cursor is not moved. The vectors are zero-filled
+     * on the calling thread before decoding starts. For large files, use
+     * read_all_parallel_into() with caller buffers, for example from
+     * std::make_unique_for_overwrite<T[]>(), to skip that pass.
+     * @tparam T The type to convert the samples to
+     * @param numThreads The number of threads, or 0 to use one per hardware
+     * thread
+     * @return The samples, one vector per channel
+     */
+    template<AllowedAudioDataType T>
+    auto read_all_parallel(const size_t numThreads = 0) const
+            -> std::vector<std::vector<T>> {
+        std::vector<std::vector<T>> samples(
+                m_config.numChannels, std::vector<T>(m_config.num_samples()));
+        std::vector<T *> sampleArrays(m_config.numChannels);
+        for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+            sampleArrays[ch] = samples[ch].data();
         }
-        return output;
+        const size_t framesRead =
+                read_all_parallel_into(sampleArrays.data(), numThreads);
+        for (auto &channel : samples) {
+            channel.resize(framesRead);
+        }
+        return samples;
     }
 
     /**
-     * @brief Reads an array of samples from the WAV file.
-     * @tparam T The type of the samples
-     * @param count The number of samples to read
+     * @brief Reads the whole data chunk into caller-provided buffers,
+     * decoding frame-aligned ranges on several threads.
+     * @details The reader's cursor is not moved. The buffers are only
+     * written by the thread decoding each range, so uninitialized buffers
+     * have each page first touched, and placed on a NUMA node, by that
+     * thread.
+     * @tparam T The type to convert the samples to
+     * @param sampleArrays The output samples, one array per channel, each
+     * holding at least get_configuration().num_samples() samples
+     * @param numThreads The number of threads, or 0 to use one per hardware
+     * thread
+     * @return The number of frames read, which is less than the number of
+     * samples when the file is shorter than its header claims
      */
     template<AllowedAudioDataType T>
-    auto read_samples(const size_t count) -> std::vector<std::vector<T>> {
-        std::vector<T> interleavedSamples(count * m_config.numChannels);
-        m_fileStream.read(reinterpret_cast<char *>(interleavedSamples.data()),
-                          static_cast<std::streamsize>(
-                                  interleavedSamples.size() * sizeof(T)));
-        const size_t samplesRead = m_fileStream.gcount() / sizeof(T);
-        size_t framesRead = samplesRead / m_config.numChannels;
-        std::vector<std::vector<T>> deinterleavedSamples(
-                m_config.numChannels, std::vector<T>(framesRead));
-        for (size_t i = 0; i < framesRead; ++i) {
-            for (size_t j = 0; j < m_config.numChannels; ++j) {
-                deinterleavedSamples[j][i] =
-                        interleavedSamples[i * m_config.numChannels + j];
+    auto read_all_parallel_into(T *const *sampleArrays,
+                                size_t numThreads = 0) const -> size_t {
+        const size_t totalFrames = m_config.num_samples();
+        if (totalFrames == 0) {
+            return 0;
+        }
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        /// Do not split the file into ranges too small to be worth a thread
+        const size_t minFrames =
+                std::max<size_t>(1, kMaxChunkBytes / m_config.blockAlign);
+        numThreads = std::clamp<size_t>((totalFrames + minFrames - 1) / minFrames,
+                                        1, numThreads);
+        const size_t rangeFrames = (totalFrames + numThreads - 1) / numThreads;
+
+        std::vector<size_t> framesRead(numThreads);
+        const auto readRange = [&](const size_t range) {
+            const size_t begin = range * rangeFrames;
+            const size_t count = std::min(rangeFrames, totalFrames - begin);
+            std::vector<T *> rangeArrays(m_config.numChannels);
+            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+                rangeArrays[ch] = sampleArrays[ch] + begin;
             }
+            framesRead[range] = read_at(begin, count, rangeArrays.data());
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (size_t range = 1; range < numThreads; ++range) {
+            threads.emplace_back(readRange, range);
+        }
+        readRange(0);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        /// Keep only the frames up to the first short range, which happens
+        /// when the file is shorter than its header claims
+        size_t validFrames = 0;
+        for (size_t range = 0; range < numThreads; ++range) {
+            validFrames += framesRead[range];
+            if (framesRead[range] <
+                std::min(rangeFrames, totalFrames - range * rangeFrames)) {
+                break;
+            }
+        }
+        return validFrames;
+    }
+
+private:
+    /** Frees memory from std::aligned_alloc */
+    struct AlignedDeleter {
+        auto operator()(uint8_t *buffer) const -> void { std::free(buffer); }
+    };
+
+    /** A sector-aligned buffer for O_DIRECT reads, grown when needed */
+    struct AlignedBuffer {
+        /** The buffer, or nullptr before the first O_DIRECT read */
+        std::unique_ptr<uint8_t, AlignedDeleter> data;
+        /** The size of the buffer */
+        size_t size = 0;
+    };
+
+    /**
+     * @brief Private constructor
+     * @param filename The filename of the WAV file
+     */
+    WavReader(std::string filename, const WavReaderOptions options) :
+        m_options(options), m_stats(make_wav_stats(options.collectStats)) {
+        if (options.trackLatency) {
+            m_latency = std::make_unique<WavLatencyHistogram>(
+                    options.deadlineNanoseconds);
         }
+        m_config.filename = std::move(filename);
+    }
 
-        return deinterleavedSamples;
+    /**
+     * @brief Reads and decodes samples from a given position.
+     * @tparam T The type to convert the samples to
+     * @param frame The index of the first frame to read
+     * @param count The number of frames to read
+     * @param sampleArrays The output samples, one array per channel
+     * @param raw The buffer for the raw bytes, grown if needed
+     * @param directBuffer The aligned buffer for O_DIRECT reads, grown if
+     * needed
+     * @param hasher The hasher updated with the raw bytes, if any
+     * @return The number of frames read
+     */
+    template<AllowedAudioDataType T>
+    auto read_frames(const size_t frame, const size_t count,
+                     T *const *sampleArrays, std::vector<uint8_t> &raw,
+                     AlignedBuffer &directBuffer,
+                     WavHasher *hasher = nullptr) const -> size_t {
+        const size_t totalFrames = m_config.num_samples();
+        if (m_fileDescriptor < 0 || frame >= totalFrames) {
+            return 0;
+        }
+        const size_t framesToRead = std::min(count, totalFrames - frame);
+        WAV_TRACE3(read_block_start, this, frame, framesToRead);
+        /// Read in bounded chunks so large reads do not need a raw buffer
+        /// the size of the whole range
+        const size_t chunkFrames =
+                std::max<size_t>(1, kMaxChunkBytes / m_config.blockAlign);
+        const size_t rawBytes =
+                std::min(framesToRead, chunkFrames) * m_config.blockAlign;
+        if (raw.size() < rawBytes) {
+            raw.resize(rawBytes);
+            if (m_stats) {
+                m_stats->add_allocations();
+            }
+        }
+        const WavStatsPhase codecPhase = wav_codec_phase<T>(m_config);
+        size_t framesRead = 0;
+        while (framesRead < framesToRead) {
+            const size_t frames =
+                    std::min(framesToRead - framesRead, chunkFrames);
+            size_t bytesRead = 0;
+            {
+                const WavStatsTimer timer(m_stats.get(), WavStatsPhase::IO);
+                bytesRead = read_raw_at(
+                        m_headerLayout.dataOffset +
+                                (frame + framesRead) * m_config.blockAlign,
+                        raw.data(), frames * m_config.blockAlign,
+                        directBuffer);
+            }
+            const size_t chunkRead = bytesRead / m_config.blockAlign;
+            if (hasher != nullptr) {
+                hasher->update(raw.data(), chunkRead * m_config.blockAlign);
+            }
+            {
+                const WavStatsTimer timer(m_stats.get(), codecPhase);
+                decode_frames(raw.data(), chunkRead, m_config, sampleArrays,
+                              framesRead);
+            }
+            if (m_stats) {
+                m_stats->add_data(chunkRead * m_config.blockAlign, chunkRead);
+            }
+            framesRead += chunkRead;
+            if (chunkRead < frames) {
+                break;
+            }
+        }
+        WAV_TRACE6(read_block, this, frame, framesRead,
+                   framesRead * m_config.blockAlign, m_config.format,
+                   m_config.bitDepth);
+        return framesRead;
     }
 
     /**
-     * @brief Reads raw samples from the WAV file.
+     * @brief Reads raw bytes from a given offset in the WAV file.
+     * @param offset The offset in the file to read from
+     * @param buffer The buffer to read into
      * @param byteCount The number of bytes to read
-     * @return The raw samples
+     * @param directBuffer The aligned buffer for O_DIRECT reads, grown if
+     * needed
+     * @return The number of bytes read, which is less than byteCount at the
+     * end of the file or on error
      */
-    auto read_raw_samples(size_t byteCount) -> std::vector<uint8_t>;
+    auto read_raw_at(uint64_t offset, uint8_t *buffer, size_t byteCount,
+                     AlignedBuffer &directBuffer) const -> size_t;
 
     /**
-     * @brief Opens the WAV file for reading.
-     * @return True if the file was opened successfully, false otherwise
+     * @brief Reads raw bytes through an aligned buffer, for O_DIRECT.
+     * @param offset The offset in the file to read from
+     * @param buffer The buffer to read into
+     * @param byteCount The number of bytes to read
+     * @param directBuffer The aligned buffer to read through, grown if needed
+     * @return The number of bytes read
      */
-    auto open_file() -> bool;
+    auto read_direct_at(uint64_t offset, uint8_t *buffer, size_t byteCount,
+                        AlignedBuffer &directBuffer) const -> size_t;
 
     /**
-     * @brief Read the WAV file header.
+     * @brief Applies the read-ahead and drop-behind hints after read() moved
+     * the cursor.
      */
-    auto read_header() -> bool;
+    auto advise_consumed() -> void;
+
+    /**
+     * @brief Opens the WAV file for reading.
+     * @return True if the file was opened successfully, false otherwise
+     */
+    auto open_file() -> bool;
 
     /**
      * @brief Gets the number of samples in the WAV file.
@@ -266,11 +557,168 @@ private:
      */
     auto num_samples() const -> uint32_t;
 
+    /** The largest raw buffer used by a single read */
+    static constexpr size_t kMaxChunkBytes = 1 << 20;
+
     /** The configuration for the WAV reader */
     WavFileConfiguration m_config = {};
 
-    /** The file stream for the WAV file */
-    std::ifstream m_fileStream;
+    /** The offsets of the header fields */
+    WavHeaderLayout m_headerLayout = {};
+
+    /** The file descriptor for the WAV file */
+    int m_fileDescriptor = -1;
+
+    /** The index of the next frame returned by read() */
+    size_t m_cursor = 0;
+
+    /** The raw buffer reused by read_into() */
+    std::vector<uint8_t> m_readBuffer;
+
+    /** The aligned buffer reused by read_into() with O_DIRECT */
+    AlignedBuffer m_directBuffer;
+
+    /** The page cache hints and I/O mode */
+    WavReaderOptions m_options = {};
+
+    /** Whether the file was opened with O_DIRECT */
+    bool m_directIo = false;
+
+    /** The file offset up to which pages were dropped from the cache */
+    uint64_t m_droppedUntil = 0;
+
+    /** The hash of the payload read in order so far */
+    WavHasher m_hasher;
+
+    /** The number of frames covered by the hash */
+    size_t m_hashedFrames = 0;
+
+    /** The statistics, or nullptr when they are not collected */
+    std::unique_ptr<WavStatsCounters> m_stats;
+
+    /** The latencies of read_into(), or nullptr when they are not recorded */
+    std::unique_ptr<WavLatencyHistogram> m_latency;
 };
 
+/**
+ * @brief Input view reading a WAV file in fixed-size blocks.
+ * @details Returned by WavReader::blocks(). The view owns one buffer per
+ * channel, allocated once, which every block is read into, so the spans
+ * yielded for a block are only valid until the iterator is advanced.
+ * @tparam T The type to convert the samples to
+ */
+template<AllowedAudioDataType T>
+class WavBlockView : public std::ranges::view_interface<WavBlockView<T>> {
+public:
+    /** Input iterator over the blocks of the view */
+    class Iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::span<const std::span<T>>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        /**
+         * @brief Public constructor
+         * @param view The view being iterated
+         */
+        explicit Iterator(WavBlockView *view) : m_view(view) {}
+
+        /** Gets the per-channel spans of the current block */
+        auto operator*() const -> value_type { return m_view->m_spans; }
+
+        /** Reads the next block */
+        auto operator++() -> Iterator & {
+            m_view->read_block();
+            return *this;
+        }
+
+        /** Reads the next block */
+        auto operator++(int) -> void { ++*this; }
+
+        /** The iterator is at the end once a block comes back empty */
+        friend auto operator==(const Iterator &it, std::default_sentinel_t)
+                -> bool {
+            return it.at_end();
+        }
+
+    private:
+        /** Checks whether the last block read was empty */
+        [[nodiscard]] auto at_end() const -> bool {
+            return m_view->m_framesRead == 0;
+        }
+
+        /** The view being iterated */
+        WavBlockView *m_view = nullptr;
+    };
+
+    /**
+     * @brief Public constructor
+     * @param reader The reader, which must outlive the view
+     * @param frames The number of frames per block
+     */
+    WavBlockView(WavReader &reader, const size_t frames) :
+        m_reader(&reader),
+        m_samples(reader.get_configuration().numChannels,
+                  std::vector<T>(std::max<size_t>(1, frames))) {
+        m_sampleArrays.reserve(m_samples.size());
+        for (auto &channel : m_samples) {
+            m_sampleArrays.push_back(channel.data());
+        }
+        m_spans.resize(m_samples.size());
+    }
+
+    /** Reads the first block and gets an iterator to it */
+    auto begin() -> Iterator {
+        read_block();
+        return Iterator(this);
+    }
+
+    /** Gets the end of the view */
+    auto end() const -> std::default_sentinel_t { return {}; }
+
+private:
+    /**
+     * @brief Reads the next block into the view's buffers.
+     */
+    auto read_block() -> void {
+        /// A copied view must read into its own buffers, not the source's
+        for (size_t ch = 0; ch < m_samples.size(); ++ch) {
+            m_sampleArrays[ch] = m_samples[ch].data();
+        }
+        m_framesRead = m_reader->read_into(m_samples[0].size(),
+                                           m_sampleArrays.data());
+        for (size_t ch = 0; ch < m_samples.size(); ++ch) {
+            m_spans[ch] = std::span<T>(m_samples[ch].data(), m_framesRead);
+        }
+    }
+
+    /** The reader */
+    WavReader *m_reader;
+
+    /** The buffer of each channel */
+    std::vector<std::vector<T>> m_samples;
+
+    /** Pointers to the buffer of each channel */
+    std::vector<T *> m_sampleArrays;
+
+    /** The frames of the current block in each channel */
+    std::vector<std::span<T>> m_spans;
+
+    /** The number of frames in the current block */
+    size_t m_framesRead = 0;
+};
+
+/**
+ * @brief Gets a view that reads the rest of the file in blocks.
+ * @tparam T The type to convert the samples to
+ * @param frames The number of frames per block
+ * @return The block view
+ */
+template<AllowedAudioDataType T>
+auto WavReader::blocks(const size_t frames) -> WavBlockView<T> {
+    return WavBlockView<T>(*this, frames);
+}
+
 #endif // WAV_READER_H
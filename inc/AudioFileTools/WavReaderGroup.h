@@ -0,0 +1,218 @@
+/// WavReaderGroup.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_READER_GROUP_H
+#define WAV_READER_GROUP_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavReader.h"
+#include "WavThreadPool.h"
+
+/** Options for a group of WAV readers */
+struct WavReaderGroupOptions {
+    /** The number of I/O threads */
+    size_t numThreads = 4;
+    /** The number of frames past each read that are prefetched, or 0 to
+     * disable read-ahead */
+    size_t readAheadFrames = 1 << 16;
+};
+
+/**
+ * @brief Reads many WAV files in lockstep, as one multichannel stream.
+ * @details All files share one position. Each read fetches the block of
+ * every file in a single round on a small pool of I/O threads, then asks the
+ * kernel to prefetch the following frames so the next round is served from
+ * the page cache. The channels of the files are concatenated in order.
+ */
+class WavReaderGroup {
+public:
+    /**
+     * @brief Public constructor that opens the WAV files.
+     * @details The files must share the sample rate, bit depth and format,
+     * but may have different numbers of channels and lengths.
+     * @param filenames The filenames of the WAV files
+     * @param options The group options
+     * @return A reader group object if every file was opened and the formats
+     * match, std::nullopt otherwise
+     */
+    static auto create(const std::vector<std::string> &filenames,
+                       WavReaderGroupOptions options = {})
+            -> std::optional<WavReaderGroup>;
+
+    /**
+     * @brief Gets the configuration of one file of the group.
+     * @param index The index of the file
+     * @return The configuration of the file
+     */
+    auto get_configuration(size_t index) -> WavFileConfiguration;
+
+    /**
+     * @brief Gets the number of files in the group.
+     * @return The number of files
+     */
+    [[nodiscard]] auto size() const -> size_t;
+
+    /**
+     * @brief Gets the total number of channels across all files.
+     * @return The number of channels
+     */
+    [[nodiscard]] auto num_channels() const -> size_t;
+
+    /**
+     * @brief Gets the length of the longest file.
+     * @return The number of frames
+     */
+    [[nodiscard]] auto num_frames() const -> size_t;
+
+    /**
+     * @brief Moves the position of every file.
+     * @param frame The index of the next frame to read
+     * @return True if the frame is within the longest file, false otherwise
+     */
+    auto seek_frame(size_t frame) -> bool;
+
+    /**
+     * @brief Gets the shared position.
+     * @return The index of the next frame to read
+     */
+    [[nodiscard]] auto tell_frame() const -> size_t;
+
+    /**
+     * @brief Reads a block of every file from the current position and
+     * advances it.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @return The samples, one vector per channel across all files
+     */
+    template<AllowedAudioDataType T>
+    auto read(const size_t count) -> std::vector<std::vector<T>> {
+        std::vector<std::vector<T>> samples(num_channels(),
+                                            std::vector<T>(count));
+        std::vector<T *> sampleArrays(samples.size());
+        for (size_t ch = 0; ch < samples.size(); ++ch) {
+            sampleArrays[ch] = samples[ch].data();
+        }
+        const size_t framesRead = read_into(count, sampleArrays.data());
+        for (auto &channel : samples) {
+            channel.resize(framesRead);
+        }
+        return samples;
+    }
+
+    /**
+     * @brief Reads a block of every file from the current position into
+     * caller-provided buffers and advances it.
+     * @details Files shorter than the block are padded with silence.
+     * @tparam T The type to convert the samples to
+     * @param count The number of frames to read
+     * @param sampleArrays The output samples, one array per channel across
+     * all files, each holding at least count samples
+     * @return The number of frames read from the longest file, which is less
+     * than count at the end of the group
+     */
+    template<AllowedAudioDataType T>
+    auto read_into(const size_t count, T *const *sampleArrays) -> size_t {
+        std::atomic<size_t> framesRead = 0;
+        for (size_t i = 0; i < m_readers.size(); ++i) {
+            m_pool->submit([this, i, count, sampleArrays, &framesRead] {
+                WavReader &reader = m_readers[i];
+                T *const *trackArrays = sampleArrays + m_channelOffsets[i];
+                const size_t frames = reader.read_into(count, trackArrays);
+                const size_t numChannels = m_channelOffsets[i + 1] -
+                                           m_channelOffsets[i];
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    std::fill(trackArrays[ch] + frames, trackArrays[ch] + count,
+                              convert_sample<float, T>(0.0f));
+                }
+                if (m_options.readAheadFrames > 0) {
+                    reader.prefetch(reader.tell_frame(),
+                                    m_options.readAheadFrames);
+                }
+                size_t longest = framesRead.load(std::memory_order_relaxed);
+                while (frames > longest &&
+                       !framesRead.compare_exchange_weak(
+                               longest, frames, std::memory_order_relaxed)) {
+                }
+            });
+        }
+        m_pool->wait();
+        /// Files that ended stay at their end, which is where seek_frame()
+        /// would put them
+        m_cursor += framesRead;
+        return framesRead;
+    }
+
+    /**
+     * @brief Overloaded move constructor
+     * @param other The other reader group object
+     */
+    WavReaderGroup(WavReaderGroup &&other) noexcept :
+        m_options(other.m_options), m_readers(std::move(other.m_readers)),
+        m_channelOffsets(std::move(other.m_channelOffsets)),
+        m_numFrames(other.m_numFrames), m_cursor(other.m_cursor),
+        m_pool(std::move(other.m_pool)) {}
+
+    /** Delete copy constructor and assignment operators */
+    WavReaderGroup(const WavReaderGroup &) = delete;
+    WavReaderGroup &operator=(const WavReaderGroup &) = delete;
+    WavReaderGroup &operator=(WavReaderGroup &&) = delete;
+
+private:
+    /**
+     * @brief Private constructor
+     * @param options The group options
+     */
+    explicit WavReaderGroup(const WavReaderGroupOptions options) :
+        m_options(options) {}
+
+    /** The group options */
+    WavReaderGroupOptions m_options;
+
+    /** The reader of each file */
+    std::vector<WavReader> m_readers;
+
+    /** The first output channel of each file, followed by the total */
+    std::vector<size_t> m_channelOffsets;
+
+    /** The length of the longest file */
+    size_t m_numFrames = 0;
+
+    /** The shared position */
+    size_t m_cursor = 0;
+
+    /** The pool running the reads */
+    std::unique_ptr<WavThreadPool> m_pool;
+};
+
+#endif // WAV_READER_GROUP_H
@@ -0,0 +1,134 @@
+/// WavRealtime.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef WAV_REALTIME_H
+#define WAV_REALTIME_H
+
+#include <cstdint>
+
+/**
+ * Real-time safety checks. When AUDIO_FILE_TOOLS_RT_CHECKS is 1, the global
+ * operator new and delete are replaced and the library reports its system
+ * calls and locks, and any of them made inside a WavRealtimeScope on the
+ * same thread is counted as a violation. WavWriter::write_buffer(),
+ * WavWriter::write_encoded(), WavReader::read_into(),
+ * WavWriterGroup::write_buffer() and WavRingProducer::write_buffer() open a
+ * scope themselves. This is a debug
+ * mode for tests; with the default of 0 the checks compile to nothing.
+ */
+#ifndef AUDIO_FILE_TOOLS_RT_CHECKS
+#define AUDIO_FILE_TOOLS_RT_CHECKS 0
+#endif
+
+/** The kinds of real-time safety violations */
+enum class WavRealtimeViolationKind { ALLOCATION, DEALLOCATION, BLOCKING_CALL };
+
+/** The violations counted on one thread */
+struct WavRealtimeViolations {
+    /** The number of allocations */
+    uint64_t allocations = 0;
+    /** The number of deallocations */
+    uint64_t deallocations = 0;
+    /** The number of system calls and locks */
+    uint64_t blockingCalls = 0;
+    /** The name of the last violating call, or nullptr if there was none */
+    const char *lastCall = nullptr;
+
+    /**
+     * @brief Gets the total number of violations.
+     * @return The number of violations
+     */
+    [[nodiscard]] auto total() const -> uint64_t {
+        return allocations + deallocations + blockingCalls;
+    }
+};
+
+/**
+ * @brief Marks the calling thread as real-time until it goes out of scope.
+ * @details Scopes nest. Entering and leaving a scope touches only
+ * thread-local state.
+ */
+class WavRealtimeScope {
+public:
+    /**
+     * @brief Public constructor
+     */
+    WavRealtimeScope();
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavRealtimeScope();
+
+    /** Delete copy constructor and copy assignment operator */
+    WavRealtimeScope(const WavRealtimeScope &) = delete;
+    WavRealtimeScope &operator=(const WavRealtimeScope &) = delete;
+};
+
+/**
+ * @brief Checks whether the calling thread is in a real-time scope.
+ * @return True if it is, false otherwise
+ */
+auto wav_in_realtime_scope() -> bool;
+
+/**
+ * @brief Counts a violation if the calling thread is in a real-time scope.
+ * @details Never allocates, so it can be called from operator new.
+ * @param kind The kind of violation
+ * @param call The name of the call, a string literal
+ */
+auto wav_realtime_report(WavRealtimeViolationKind kind, const char *call)
+        -> void;
+
+/**
+ * @brief Gets the violations counted on the calling thread.
+ * @return The violations
+ */
+auto wav_realtime_violations() -> WavRealtimeViolations;
+
+/**
+ * @brief Sets the violations counted on the calling thread back to zero.
+ */
+auto wav_realtime_reset_violations() -> void;
+
+/**
+ * @brief Makes every violation abort the process, so a debugger stops at
+ * the offending call.
+ * @param abort Whether to abort
+ */
+auto wav_realtime_abort_on_violation(bool abort) -> void;
+
+#if AUDIO_FILE_TOOLS_RT_CHECKS
+#define WAV_REALTIME_SCOPE() const WavRealtimeScope wavRealtimeScope
+#define WAV_REALTIME_BLOCKING(call)                                           \
+    wav_realtime_report(WavRealtimeViolationKind::BLOCKING_CALL, call)
+#define WAV_REALTIME_ALLOCATION(call)                                         \
+    wav_realtime_report(WavRealtimeViolationKind::ALLOCATION, call)
+#else
+#define WAV_REALTIME_SCOPE() do { } while (false)
+#define WAV_REALTIME_BLOCKING(call) do { } while (false)
+#define WAV_REALTIME_ALLOCATION(call) do { } while (false)
+#endif
+
+#endif // WAV_REALTIME_H
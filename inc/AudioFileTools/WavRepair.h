@@ -0,0 +1,61 @@
+/// WavRepair.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_REPAIR_H
+#define WAV_REPAIR_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+
+/**
+ * @brief Repairs the RIFF and data chunk sizes of a WAV file whose writer did
+ * not finalize the header, for example after a crash.
+ * @details The data chunk size is derived from the file length, rounded down
+ * to a whole number of frames, and the two size fields are patched in place.
+ * Only the header is read, never the audio payload. Files whose sizes are
+ * already consistent are left untouched.
+ * @param filename The filename of the WAV file
+ * @return The repaired configuration if the file is a valid WAV file,
+ * std::nullopt otherwise
+ */
+auto repair_wav_header(const std::string &filename)
+        -> std::optional<WavFileConfiguration>;
+
+/**
+ * @brief Repairs the headers of many WAV files concurrently.
+ * @param filenames The filenames of the WAV files
+ * @param numThreads The number of worker threads, or 0 to use one per
+ * hardware thread
+ * @return The result of repair_wav_header() for each file, in the same order
+ * as the filenames
+ */
+auto repair_wav_headers(const std::vector<std::string> &filenames,
+                        size_t numThreads = 0)
+        -> std::vector<std::optional<WavFileConfiguration>>;
+
+#endif // WAV_REPAIR_H
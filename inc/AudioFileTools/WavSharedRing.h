@@ -0,0 +1,286 @@
+/// WavSharedRing.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_SHARED_RING_H
+#define WAV_SHARED_RING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavRealtime.h"
+#include "WavWriter.h"
+
+/**
+ * @brief Header at the start of a shared-memory ring, followed by the ring
+ * buffer of encoded frames.
+ * @details The producer only advances writeFrame and the consumer only
+ * advances readFrame, each on its own cache line. Frame counters increase
+ * monotonically and are reduced modulo the capacity when indexing.
+ */
+struct WavSharedRingHeader {
+    uint32_t magic;
+    uint32_t sampleRate;
+    uint16_t numChannels;
+    uint16_t bitDepth;
+    uint16_t format;
+    uint16_t blockAlign;
+    uint64_t capacityFrames;
+    alignas(64) std::atomic<uint64_t> writeFrame;
+    alignas(64) std::atomic<uint64_t> readFrame;
+    alignas(64) std::atomic<uint32_t> finished;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The shared ring needs lock-free 64-bit atomics");
+
+/**
+ * @brief Producer side of a lock-free single-producer, single-consumer ring
+ * in POSIX shared memory.
+ * @details Samples are converted straight into the ring in the output
+ * format, so handing audio to another process costs one copy and no system
+ * calls. The producer creates the shared memory object and unlinks it when
+ * it is destroyed; a consumer that has already opened the ring keeps its
+ * mapping.
+ */
+class WavRingProducer {
+public:
+    /**
+     * @brief Public constructor that creates the shared memory ring.
+     * @param name The name of the shared memory object, starting with '/'
+     * @param configuration The format of the frames in the ring
+     * @param capacityFrames The number of frames the ring can hold
+     * @return A producer object if the ring was created, std::nullopt
+     * otherwise
+     */
+    static auto create(const std::string &name,
+                       const WavFileConfiguration &configuration,
+                       size_t capacityFrames) -> std::optional<WavRingProducer>;
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavRingProducer();
+
+    /**
+     * @brief Writes audio data to the ring without blocking.
+     * @param count Number of frames to write
+     * @param samples Pointer to the first channel of audio data
+     * @param rest Other audio channels
+     * @return The number of frames written, which is less than count when
+     * the ring is full
+     */
+    template<AllowedAudioDataType T, typename... Args>
+    auto write(const size_t count, const T *samples, Args... rest) -> size_t {
+        /// Assemble input arrays into a single array
+        constexpr size_t num_arrays = sizeof...(rest) + 1;
+        assert(num_arrays == m_config.numChannels);
+        std::array<const T *, num_arrays> sampleArrays = {samples, rest...};
+        return write_buffer(sampleArrays.data(), count);
+    }
+
+    /**
+     * @brief Writes an array of samples to the ring without blocking.
+     * @param sampleArrays The array of samples. The first dimension
+     * represents the channel, and the second dimension represents the sample.
+     * @param count The number of frames to write
+     * @return The number of frames written, which is less than count when
+     * the ring is full
+     */
+    template<AllowedAudioDataType T>
+    auto write_buffer(const T *const *sampleArrays, const size_t count)
+            -> size_t {
+        WAV_REALTIME_SCOPE();
+        const uint64_t writeFrame =
+                m_header->writeFrame.load(std::memory_order_relaxed);
+        /// Only reload the consumer's position when the cached one says
+        /// the ring is full
+        if (writeFrame - m_cachedReadFrame + count > m_capacity) {
+            m_cachedReadFrame =
+                    m_header->readFrame.load(std::memory_order_acquire);
+        }
+        const size_t frames = std::min<size_t>(
+                count, m_capacity - (writeFrame - m_cachedReadFrame));
+        /// Copy in up to two segments when the write wraps around
+        const size_t start = writeFrame % m_capacity;
+        const size_t first = std::min(frames, m_capacity - start);
+        encode_frames(sampleArrays, first, m_config,
+                      m_data + start * m_config.blockAlign);
+        if (first < frames) {
+            std::array<const T *, UINT8_MAX> offsetArrays{};
+            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+                offsetArrays[ch] = sampleArrays[ch] + first;
+            }
+            encode_frames(offsetArrays.data(), frames - first, m_config,
+                          m_data);
+        }
+        m_header->writeFrame.store(writeFrame + frames,
+                                   std::memory_order_release);
+        return frames;
+    }
+
+    /**
+     * @brief Marks the stream as finished, so the consumer stops once it has
+     * drained the ring.
+     */
+    auto finish() -> void;
+
+    /**
+     * @brief Overloaded move constructor
+     * @param other The other producer object
+     */
+    WavRingProducer(WavRingProducer &&other) noexcept :
+        m_name(std::move(other.m_name)),
+        m_config(std::move(other.m_config)),
+        m_header(other.m_header),
+        m_data(other.m_data),
+        m_mappingLength(other.m_mappingLength),
+        m_capacity(other.m_capacity),
+        m_cachedReadFrame(other.m_cachedReadFrame) {
+        other.m_header = nullptr;
+    }
+
+    /** Delete copy constructor and assignment operators */
+    WavRingProducer(const WavRingProducer &) = delete;
+    WavRingProducer &operator=(const WavRingProducer &) = delete;
+    WavRingProducer &operator=(WavRingProducer &&) = delete;
+
+private:
+    /**
+     * @brief Private constructor
+     * @param name The name of the shared memory object
+     * @param configuration The format of the frames in the ring
+     */
+    WavRingProducer(std::string name, WavFileConfiguration configuration) :
+        m_name(std::move(name)), m_config(std::move(configuration)) {}
+
+    /** The name of the shared memory object */
+    std::string m_name;
+
+    /** The format of the frames in the ring */
+    WavFileConfiguration m_config;
+
+    /** The shared header */
+    WavSharedRingHeader *m_header = nullptr;
+
+    /** The ring buffer, following the header */
+    uint8_t *m_data = nullptr;
+
+    /** The length of the mapping */
+    size_t m_mappingLength = 0;
+
+    /** The number of frames the ring can hold */
+    size_t m_capacity = 0;
+
+    /** The consumer's position as last seen by the producer */
+    uint64_t m_cachedReadFrame = 0;
+};
+
+/**
+ * @brief Consumer side of a shared-memory ring created by WavRingProducer.
+ */
+class WavRingConsumer {
+public:
+    /**
+     * @brief Public constructor that opens an existing shared memory ring.
+     * @param name The name of the shared memory object, starting with '/'
+     * @return A consumer object if the ring was opened, std::nullopt
+     * otherwise
+     */
+    static auto open(const std::string &name) -> std::optional<WavRingConsumer>;
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavRingConsumer();
+
+    /**
+     * @brief Gets the format of the frames in the ring.
+     * @return The configuration, with an empty filename
+     */
+    auto get_configuration() -> WavFileConfiguration;
+
+    /**
+     * @brief Writes every frame currently in the ring to a WAV writer.
+     * @details The encoded frames are written straight from shared memory,
+     * so the writer must have been created with the ring's configuration.
+     * @param writer The writer
+     * @return The number of frames written
+     */
+    auto drain_to(WavWriter &writer) -> size_t;
+
+    /**
+     * @brief Checks whether the producer has finished and the ring is empty.
+     * @return True if no more frames will arrive, false otherwise
+     */
+    auto is_finished() const -> bool;
+
+    /**
+     * @brief Overloaded move constructor
+     * @param other The other consumer object
+     */
+    WavRingConsumer(WavRingConsumer &&other) noexcept :
+        m_config(std::move(other.m_config)),
+        m_header(other.m_header),
+        m_data(other.m_data),
+        m_mappingLength(other.m_mappingLength),
+        m_capacity(other.m_capacity) {
+        other.m_header = nullptr;
+    }
+
+    /** Delete copy constructor and assignment operators */
+    WavRingConsumer(const WavRingConsumer &) = delete;
+    WavRingConsumer &operator=(const WavRingConsumer &) = delete;
+    WavRingConsumer &operator=(WavRingConsumer &&) = delete;
+
+private:
+    /**
+     * @brief Private constructor
+     */
+    WavRingConsumer() = default;
+
+    /** The format of the frames in the ring */
+    WavFileConfiguration m_config;
+
+    /** The shared header */
+    WavSharedRingHeader *m_header = nullptr;
+
+    /** The ring buffer, following the header */
+    const uint8_t *m_data = nullptr;
+
+    /** The length of the mapping */
+    size_t m_mappingLength = 0;
+
+    /** The number of frames the ring can hold */
+    size_t m_capacity = 0;
+};
+
+#endif // WAV_SHARED_RING_H
@@ -0,0 +1,268 @@
+/// WavStats.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef WAV_STATS_H
+#define WAV_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+
+#include "WavConfiguration.h"
+
+/** Set to 0 to compile the statistics out of WavReader and WavWriter */
+#ifndef AUDIO_FILE_TOOLS_STATS
+#define AUDIO_FILE_TOOLS_STATS 1
+#endif
+
+/** A snapshot of the statistics of a WAV reader or writer */
+struct WavIoStats {
+    /** The number of bytes read from or written to the data chunk */
+    uint64_t bytes = 0;
+    /** The number of frames read or written */
+    uint64_t frames = 0;
+    /** The number of read or write calls made to the operating system */
+    uint64_t ioCalls = 0;
+    /** The number of seeks */
+    uint64_t seeks = 0;
+    /** The number of buffers allocated */
+    uint64_t allocations = 0;
+    /** The time spent in read or write calls */
+    uint64_t ioNanoseconds = 0;
+    /** The time spent converting and (de)interleaving samples whose type
+     * differs from the file's sample format */
+    uint64_t conversionNanoseconds = 0;
+    /** The time spent (de)interleaving samples whose type matches the
+     * file's sample format */
+    uint64_t interleaveNanoseconds = 0;
+};
+
+/** The phases of a read or write that are timed */
+enum class WavStatsPhase { IO, CONVERSION, INTERLEAVE };
+
+/**
+ * @brief The live statistics of a WAV reader or writer.
+ * @details The counters are relaxed atomics, so a reader shared between
+ * threads through read_at() can update them concurrently. They are updated
+ * once per block rather than once per sample.
+ */
+class WavStatsCounters {
+public:
+    /**
+     * @brief Adds to the data moved.
+     * @param bytes The number of bytes
+     * @param frames The number of frames
+     */
+    auto add_data(const uint64_t bytes, const uint64_t frames) -> void {
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        m_frames.fetch_add(frames, std::memory_order_relaxed);
+    }
+
+    /** Counts a read or write call */
+    auto add_io_call() -> void {
+        m_ioCalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts seeks.
+     * @param count The number of seeks
+     */
+    auto add_seeks(const uint64_t count = 1) -> void {
+        m_seeks.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts buffer allocations.
+     * @param count The number of allocations
+     */
+    auto add_allocations(const uint64_t count = 1) -> void {
+        m_allocations.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds to the time spent in a phase.
+     * @param phase The phase
+     * @param nanoseconds The time
+     */
+    auto add_time(const WavStatsPhase phase, const uint64_t nanoseconds)
+            -> void {
+        switch (phase) {
+            case WavStatsPhase::IO:
+                m_ioNanoseconds.fetch_add(nanoseconds,
+                                          std::memory_order_relaxed);
+                break;
+            case WavStatsPhase::CONVERSION:
+                m_conversionNanoseconds.fetch_add(nanoseconds,
+                                                  std::memory_order_relaxed);
+                break;
+            case WavStatsPhase::INTERLEAVE:
+                m_interleaveNanoseconds.fetch_add(nanoseconds,
+                                                  std::memory_order_relaxed);
+                break;
+        }
+    }
+
+    /**
+     * @brief Gets the current values of the counters.
+     * @return The statistics
+     */
+    [[nodiscard]] auto snapshot() const -> WavIoStats {
+        return {.bytes = m_bytes.load(std::memory_order_relaxed),
+                .frames = m_frames.load(std::memory_order_relaxed),
+                .ioCalls = m_ioCalls.load(std::memory_order_relaxed),
+                .seeks = m_seeks.load(std::memory_order_relaxed),
+                .allocations = m_allocations.load(std::memory_order_relaxed),
+                .ioNanoseconds =
+                        m_ioNanoseconds.load(std::memory_order_relaxed),
+                .conversionNanoseconds =
+                        m_conversionNanoseconds.load(std::memory_order_relaxed),
+                .interleaveNanoseconds = m_interleaveNanoseconds.load(
+                        std::memory_order_relaxed)};
+    }
+
+    /** Sets every counter back to zero */
+    auto reset() -> void {
+        for (auto *counter : {&m_bytes, &m_frames, &m_ioCalls, &m_seeks,
+                              &m_allocations, &m_ioNanoseconds,
+                              &m_conversionNanoseconds,
+                              &m_interleaveNanoseconds}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_ioCalls{0};
+    std::atomic<uint64_t> m_seeks{0};
+    std::atomic<uint64_t> m_allocations{0};
+    std::atomic<uint64_t> m_ioNanoseconds{0};
+    std::atomic<uint64_t> m_conversionNanoseconds{0};
+    std::atomic<uint64_t> m_interleaveNanoseconds{0};
+};
+
+/**
+ * @brief Creates the counters of a reader or writer.
+ * @param enabled Whether statistics were requested
+ * @return The counters, or nullptr if statistics are not requested or are
+ * compiled out
+ */
+inline auto make_wav_stats(const bool enabled)
+        -> std::unique_ptr<WavStatsCounters> {
+#if AUDIO_FILE_TOOLS_STATS
+    if (enabled) {
+        return std::make_unique<WavStatsCounters>();
+    }
+#else
+    (void) enabled;
+#endif
+    return nullptr;
+}
+
+/**
+ * @brief Adds the time until it goes out of scope to a phase.
+ * @details Does nothing, and does not read the clock, when the counters are
+ * null or statistics are compiled out.
+ */
+class WavStatsTimer {
+public:
+    /**
+     * @brief Public constructor
+     * @param stats The counters, or nullptr
+     * @param phase The phase the time is added to
+     */
+    WavStatsTimer(WavStatsCounters *stats, const WavStatsPhase phase)
+#if AUDIO_FILE_TOOLS_STATS
+        : m_stats(stats), m_phase(phase) {
+        if (m_stats != nullptr) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+#else
+    {
+        (void) stats;
+        (void) phase;
+    }
+#endif
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavStatsTimer() {
+#if AUDIO_FILE_TOOLS_STATS
+        if (m_stats != nullptr) {
+            m_stats->add_time(
+                    m_phase,
+                    static_cast<uint64_t>(
+                            std::chrono::duration_cast<
+                                    std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - m_start)
+                                    .count()));
+        }
+#endif
+    }
+
+    /** Delete copy constructor and copy assignment operator */
+    WavStatsTimer(const WavStatsTimer &) = delete;
+    WavStatsTimer &operator=(const WavStatsTimer &) = delete;
+
+private:
+#if AUDIO_FILE_TOOLS_STATS
+    /** The counters */
+    WavStatsCounters *m_stats;
+
+    /** The phase the time is added to */
+    WavStatsPhase m_phase;
+
+    /** The time the timer was created */
+    std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+/**
+ * @brief Gets the phase that (de)interleaving samples of a given type to or
+ * from a file falls in.
+ * @tparam T The type of the samples
+ * @param config The configuration describing the file's sample format
+ * @return WavStatsPhase::INTERLEAVE if the type matches the file's sample
+ * format, so no conversion is done, WavStatsPhase::CONVERSION otherwise
+ */
+template<AllowedAudioDataType T>
+auto wav_codec_phase(const WavFileConfiguration &config) -> WavStatsPhase {
+    bool matches = false;
+    if (config.format == WavFormat::FLOAT) {
+        matches = std::same_as<T, float>;
+    } else if (config.bitDepth == WavBitDepth::BIT_DEPTH_8) {
+        matches = std::same_as<T, uint8_t>;
+    } else if (config.bitDepth == WavBitDepth::BIT_DEPTH_16) {
+        matches = std::same_as<T, int16_t>;
+    } else if (config.bitDepth == WavBitDepth::BIT_DEPTH_32) {
+        matches = std::same_as<T, int32_t>;
+    }
+    return matches ? WavStatsPhase::INTERLEAVE : WavStatsPhase::CONVERSION;
+}
+
+#endif // WAV_STATS_H
@@ -0,0 +1,131 @@
+/// WavThreadPool.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_THREAD_POOL_H
+#define WAV_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work-stealing thread pool.
+ * @details Each worker owns a queue. Tasks submitted from a worker go to its
+ * own queue and are run newest first, while tasks submitted from other
+ * threads are spread over the queues. An idle worker steals the oldest task
+ * from the other queues before going to sleep.
+ */
+class WavThreadPool {
+public:
+    /**
+     * @brief Public constructor that starts the worker threads.
+     * @param numThreads The number of worker threads, or 0 to use one per
+     * hardware thread
+     */
+    explicit WavThreadPool(size_t numThreads = 0);
+
+    /**
+     * @brief Public destructor that runs the remaining tasks and joins the
+     * worker threads.
+     */
+    ~WavThreadPool();
+
+    /**
+     * @brief Queues a task to run on one of the worker threads.
+     * @param task The task
+     */
+    auto submit(std::function<void()> task) -> void;
+
+    /**
+     * @brief Blocks until every submitted task has finished.
+     */
+    auto wait() -> void;
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of worker threads
+     */
+    [[nodiscard]] auto size() const -> size_t;
+
+    /** Delete copy and move constructors and assignment operators */
+    WavThreadPool(const WavThreadPool &) = delete;
+    WavThreadPool &operator=(const WavThreadPool &) = delete;
+
+private:
+    /** A worker's queue of tasks */
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /**
+     * @brief Runs tasks on a worker thread until the pool is stopped.
+     * @param index The index of the worker
+     */
+    auto run_worker(size_t index) -> void;
+
+    /**
+     * @brief Takes a task from a worker's own queue, or steals one from
+     * another worker.
+     * @param index The index of the worker
+     * @param task The task taken
+     * @return True if a task was taken, false if every queue is empty
+     */
+    auto take_task(size_t index, std::function<void()> &task) -> bool;
+
+    /** The queue of each worker */
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+
+    /** The worker threads */
+    std::vector<std::thread> m_threads;
+
+    /** Guards sleeping and waking of the workers and of wait() */
+    std::mutex m_mutex;
+
+    /** Signalled when a task is queued or the pool is stopping */
+    std::condition_variable m_taskAvailable;
+
+    /** Signalled when the last pending task finishes */
+    std::condition_variable m_idle;
+
+    /** The number of tasks queued but not yet taken */
+    std::atomic<int64_t> m_queued = 0;
+
+    /** The number of tasks queued or running */
+    std::atomic<size_t> m_pending = 0;
+
+    /** The queue used by the next task submitted from outside the pool */
+    std::atomic<size_t> m_nextQueue = 0;
+
+    /** Whether the workers should exit once the queues are empty */
+    bool m_stopping = false;
+};
+
+#endif // WAV_THREAD_POOL_H
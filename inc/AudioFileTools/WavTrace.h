@@ -0,0 +1,159 @@
+/// WavTrace.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef WAV_TRACE_H
+#define WAV_TRACE_H
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * USDT (user-level statically defined tracing) probes, under the provider
+ * audio_file_tools, that bpftrace, perf and SystemTap can attach to:
+ *
+ * - reader_open(filename, fd, directIo)
+ * - header_parse(format, bitDepth, numChannels, sampleRate, dataBytes)
+ * - read_block_start(reader, frame, frames)
+ * - read_block(reader, frame, framesRead, bytes, format, bitDepth)
+ * - reader_close(reader)
+ * - writer_open(filename, directIo)
+ * - write_block_start(writer, frames)
+ * - write_block(writer, frames, bytes, format, bitDepth)
+ * - writer_finalize(writer, dataBytes, trailingBytes)
+ * - writer_close(writer)
+ *
+ * A probe is a single nop with a note describing where its arguments live,
+ * so it costs nothing until a tracer patches it. Probes in the templates of
+ * WavReader.h and WavWriter.h are emitted at every place they are inlined.
+ * Set AUDIO_FILE_TOOLS_USDT to 0 to compile them out.
+ */
+#ifndef AUDIO_FILE_TOOLS_USDT
+#define AUDIO_FILE_TOOLS_USDT 1
+#endif
+
+/**
+ * @brief Widens a probe argument to the 64-bit integer every probe argument
+ * is passed as.
+ * @param value The argument, an integer, enum or pointer
+ * @return The argument as a 64-bit integer
+ */
+template<typename T>
+auto wav_trace_arg(const T value) -> int64_t {
+    if constexpr (std::is_pointer_v<T>) {
+        return static_cast<int64_t>(reinterpret_cast<uintptr_t>(value));
+    } else {
+        return static_cast<int64_t>(value);
+    }
+}
+
+#if AUDIO_FILE_TOOLS_USDT && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define WAV_TRACE1(name, a0) \
+    DTRACE_PROBE1(audio_file_tools, name, wav_trace_arg(a0))
+#define WAV_TRACE2(name, a0, a1)                                              \
+    DTRACE_PROBE2(audio_file_tools, name, wav_trace_arg(a0),                  \
+                  wav_trace_arg(a1))
+#define WAV_TRACE3(name, a0, a1, a2)                                          \
+    DTRACE_PROBE3(audio_file_tools, name, wav_trace_arg(a0),                  \
+                  wav_trace_arg(a1), wav_trace_arg(a2))
+#define WAV_TRACE4(name, a0, a1, a2, a3)                                      \
+    DTRACE_PROBE4(audio_file_tools, name, wav_trace_arg(a0),                  \
+                  wav_trace_arg(a1), wav_trace_arg(a2), wav_trace_arg(a3))
+#define WAV_TRACE5(name, a0, a1, a2, a3, a4)                                  \
+    DTRACE_PROBE5(audio_file_tools, name, wav_trace_arg(a0),                  \
+                  wav_trace_arg(a1), wav_trace_arg(a2), wav_trace_arg(a3),    \
+                  wav_trace_arg(a4))
+#define WAV_TRACE6(name, a0, a1, a2, a3, a4, a5)                              \
+    DTRACE_PROBE6(audio_file_tools, name, wav_trace_arg(a0),                  \
+                  wav_trace_arg(a1), wav_trace_arg(a2), wav_trace_arg(a3),    \
+                  wav_trace_arg(a4), wav_trace_arg(a5))
+#elif AUDIO_FILE_TOOLS_USDT && defined(__x86_64__) && defined(__ELF__)
+/// Without the systemtap headers, emit the same .note.stapsdt layout that
+/// <sys/sdt.h> does: a nop, and a note holding its address, the provider,
+/// the probe name and the location of each argument
+#define WAV_TRACE_NOTE(name, args)                                            \
+    "990: nop\n"                                                              \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                             \
+    ".balign 4\n"                                                             \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                        \
+    "991: .asciz \"stapsdt\"\n"                                               \
+    "992: .balign 4\n"                                                        \
+    "993: .8byte 990b\n"                                                      \
+    ".8byte _.stapsdt.base\n"                                                 \
+    ".8byte 0\n"                                                              \
+    ".asciz \"audio_file_tools\"\n"                                           \
+    ".asciz \"" #name "\"\n"                                                  \
+    ".asciz \"" args "\"\n"                                                   \
+    "994: .balign 4\n"                                                        \
+    ".popsection\n"                                                           \
+    ".ifndef _.stapsdt.base\n"                                                \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"   \
+    ".weak _.stapsdt.base\n"                                                  \
+    ".hidden _.stapsdt.base\n"                                                \
+    "_.stapsdt.base: .space 1\n"                                              \
+    ".size _.stapsdt.base, 1\n"                                               \
+    ".popsection\n"                                                           \
+    ".endif\n"
+#define WAV_TRACE_ARG(n, value) [a##n] "nor"(wav_trace_arg(value))
+#define WAV_TRACE1(name, a0)                                                  \
+    __asm__ __volatile__(WAV_TRACE_NOTE(name, "-8@%[a0]")                     \
+                         : : WAV_TRACE_ARG(0, a0))
+#define WAV_TRACE2(name, a0, a1)                                              \
+    __asm__ __volatile__(WAV_TRACE_NOTE(name, "-8@%[a0] -8@%[a1]")            \
+                         : : WAV_TRACE_ARG(0, a0), WAV_TRACE_ARG(1, a1))
+#define WAV_TRACE3(name, a0, a1, a2)                                          \
+    __asm__ __volatile__(                                                     \
+            WAV_TRACE_NOTE(name, "-8@%[a0] -8@%[a1] -8@%[a2]")                \
+            : : WAV_TRACE_ARG(0, a0), WAV_TRACE_ARG(1, a1),                   \
+              WAV_TRACE_ARG(2, a2))
+#define WAV_TRACE4(name, a0, a1, a2, a3)                                      \
+    __asm__ __volatile__(                                                     \
+            WAV_TRACE_NOTE(name, "-8@%[a0] -8@%[a1] -8@%[a2] -8@%[a3]")       \
+            : : WAV_TRACE_ARG(0, a0), WAV_TRACE_ARG(1, a1),                   \
+              WAV_TRACE_ARG(2, a2), WAV_TRACE_ARG(3, a3))
+#define WAV_TRACE5(name, a0, a1, a2, a3, a4)                                  \
+    __asm__ __volatile__(                                                     \
+            WAV_TRACE_NOTE(name,                                              \
+                           "-8@%[a0] -8@%[a1] -8@%[a2] -8@%[a3] -8@%[a4]")    \
+            : : WAV_TRACE_ARG(0, a0), WAV_TRACE_ARG(1, a1),                   \
+              WAV_TRACE_ARG(2, a2), WAV_TRACE_ARG(3, a3),                     \
+              WAV_TRACE_ARG(4, a4))
+#define WAV_TRACE6(name, a0, a1, a2, a3, a4, a5)                              \
+    __asm__ __volatile__(                                                     \
+            WAV_TRACE_NOTE(name, "-8@%[a0] -8@%[a1] -8@%[a2] -8@%[a3] "       \
+                                 "-8@%[a4] -8@%[a5]")                         \
+            : : WAV_TRACE_ARG(0, a0), WAV_TRACE_ARG(1, a1),                   \
+              WAV_TRACE_ARG(2, a2), WAV_TRACE_ARG(3, a3),                     \
+              WAV_TRACE_ARG(4, a4), WAV_TRACE_ARG(5, a5))
+#else
+#define WAV_TRACE1(name, a0) do { } while (false)
+#define WAV_TRACE2(name, a0, a1) do { } while (false)
+#define WAV_TRACE3(name, a0, a1, a2) do { } while (false)
+#define WAV_TRACE4(name, a0, a1, a2, a3) do { } while (false)
+#define WAV_TRACE5(name, a0, a1, a2, a3, a4) do { } while (false)
+#define WAV_TRACE6(name, a0, a1, a2, a3, a4, a5) do { } while (false)
+#endif
+
+#endif // WAV_TRACE_H
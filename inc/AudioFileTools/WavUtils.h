@@ -143,4 +143,36 @@ auto convert_uint8_to_int32(uint8_t sample) -> int32_t;
  */
 auto convert_int16_to_int32(int16_t sample) -> int32_t;
 
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to a float sample.
+ * @param sample The int24 sample
+ * @return The float sample
+ */
+auto convert_int24_to_float(int32_t sample) -> float;
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an uint8_t sample.
+ * @param sample The int24 sample
+ * @return The uint8_t sample
+ */
+auto convert_int24_to_uint8(int32_t sample) -> uint8_t;
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an int16_t sample.
+ * @param sample The int24 sample
+ * @return The int16_t sample
+ */
+auto convert_int24_to_int16(int32_t sample) -> int16_t;
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an int32_t sample.
+ * @param sample The int24 sample
+ * @return The int32_t sample
+ */
+auto convert_int24_to_int32(int32_t sample) -> int32_t;
+
 #endif // WAV_UTILS_H
@@ -0,0 +1,162 @@
+/// WavVerify.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_VERIFY_H
+#define WAV_VERIFY_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "WavConfiguration.h"
+
+/** Problems found when verifying a WAV file */
+enum class WavVerifyIssue {
+    /** The file could not be opened */
+    OPEN_FAILED,
+    /** The file does not start with a RIFF/WAVE header */
+    NOT_WAVE,
+    /** The RIFF chunk size does not match the file size */
+    RIFF_SIZE_MISMATCH,
+    /** A chunk other than the data chunk runs past the end of the file */
+    CHUNK_OVERRUN,
+    /** An odd-sized chunk is not followed by its pad byte */
+    MISSING_PADDING,
+    /** There is no fmt chunk */
+    MISSING_FORMAT,
+    /** The fmt chunk describes a format the library does not support */
+    UNSUPPORTED_FORMAT,
+    /** There is no data chunk */
+    MISSING_DATA,
+    /** The data chunk size runs past the end of the file */
+    TRUNCATED_DATA,
+    /** The data chunk size is not a whole number of frames */
+    PARTIAL_FRAME,
+    /** The payload does not match the stored hash */
+    HASH_MISMATCH,
+};
+
+/**
+ * @brief Gets the name of an issue, as used in reports.
+ * @param issue The issue
+ * @return The name of the issue
+ */
+auto to_string(WavVerifyIssue issue) -> const char *;
+
+/** Options for verifying WAV files */
+struct WavVerifyOptions {
+    /** The number of worker threads, or 0 to use one per hardware thread */
+    size_t numThreads = 0;
+    /** Hash the payload of files that store a hash and compare the two,
+     * which reads the whole file */
+    bool checkHash = false;
+};
+
+/** The outcome of verifying one WAV file */
+struct WavVerifyReport {
+    /** The filename of the WAV file */
+    std::string filename;
+    /** The problems found, empty if the file is valid */
+    std::vector<WavVerifyIssue> issues;
+    /** The size of the file in bytes */
+    uint64_t fileSize = 0;
+    /** The configuration, if the header could be parsed */
+    std::optional<WavFileConfiguration> config;
+    /** Whether a stored hash was compared against the payload */
+    bool hashChecked = false;
+
+    /** Whether no problems were found */
+    [[nodiscard]] auto valid() const -> bool { return issues.empty(); }
+};
+
+/**
+ * @brief Verifies the structure of a WAV file.
+ * @details Walks every chunk of the file reading only the chunk headers and
+ * the fmt chunk, so the cost does not depend on the length of the audio,
+ * unless the payload hash is checked.
+ * @param filename The filename of the WAV file
+ * @param options The verification options
+ * @return The report for the file
+ */
+auto verify_wav_file(const std::string &filename,
+                     const WavVerifyOptions &options = {}) -> WavVerifyReport;
+
+/**
+ * @brief Verifies many WAV files concurrently on a thread pool.
+ * @param filenames The filenames of the WAV files
+ * @param options The verification options
+ * @return The report for each file, in the same order as the filenames
+ */
+auto verify_wav_files(const std::vector<std::string> &filenames,
+                      const WavVerifyOptions &options = {})
+        -> std::vector<WavVerifyReport>;
+
+/**
+ * @brief Callback receiving the report of one file.
+ * @param index The index of the file in the list
+ * @param report The report for the file
+ */
+using WavVerifyCallback =
+        std::function<void(size_t index, const WavVerifyReport &report)>;
+
+/**
+ * @brief Verifies a list of WAV files read one filename per line,
+ * concurrently on a thread pool.
+ * @details The workers take the next line as they become free, so neither
+ * the list nor the reports are held in memory, and any number of files can
+ * be verified. Empty lines are skipped. The callback is invoked as each file
+ * finishes, so reports arrive out of order, but never concurrently.
+ * @param filenames The stream of filenames, one per line
+ * @param callback The callback receiving the report for each file
+ * @param options The verification options
+ * @return The number of files verified
+ */
+auto verify_wav_files(std::istream &filenames,
+                      const WavVerifyCallback &callback,
+                      const WavVerifyOptions &options = {}) -> size_t;
+
+/**
+ * @brief Writes verification reports as a JSON array.
+ * @param stream The stream to write to
+ * @param reports The reports
+ */
+auto write_wav_verify_json(std::ostream &stream,
+                           const std::vector<WavVerifyReport> &reports)
+        -> void;
+
+/**
+ * @brief Writes one verification report as a JSON object, so reports can be
+ * streamed as they are produced.
+ * @param stream The stream to write to
+ * @param report The report
+ */
+auto write_wav_verify_json(std::ostream &stream,
+                           const WavVerifyReport &report) -> void;
+
+#endif // WAV_VERIFY_H
@@ -25,15 +25,50 @@ SOFTWARE.
 #ifndef WAV_WRITER_H
 #define WAV_WRITER_H
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavHash.h"
+#include "WavHeader.h"
+#include "WavLatency.h"
+#include "WavRealtime.h"
+#include "WavStats.h"
+#include "WavTrace.h"
 #include "WavUtils.h"
 
+/** I/O mode for a WAV writer */
+struct WavWriterOptions {
+    /** Bypass the page cache with O_DIRECT, through an aligned staging
+     * buffer. Falls back to buffered writes when the file system does not
+     * support it */
+    bool directIo = false;
+    /** The size of the staging buffer used with O_DIRECT, rounded up to
+     * whole sectors */
+    size_t stagingBytes = 1 << 20;
+    /** Store the hash of the data chunk payload in a chunk after it when
+     * closing, see read_wav_stored_hash(). The file can then no longer be
+     * reopened with open_append() */
+    bool storeHash = false;
+    /** Count the data moved and time spent by the writer, see
+     * WavWriter::get_stats() */
+    bool collectStats = false;
+    /** Record the latency of each write call, see WavWriter::get_latency() */
+    bool trackLatency = false;
+    /** The latency over which a write call counts as a deadline miss, for
+     * example wav_block_period() of the block size, or 0 for none */
+    uint64_t deadlineNanoseconds = 0;
+};
+
 /**
  * @brief WAV file writer class.
  * @details The WAV file writer class writes audio data to a WAV file.
@@ -44,10 +79,85 @@ public:
      * @brief Public constructor that verifies the configuration and creates a
      * WAV file writer object.
      * @param configuration WAV writer configuration
+     * @param options The I/O mode
      * @return A WAV writer object if the configuration is valid, std::nullopt
      * otherwise
      */
-    static auto create(WavFileConfiguration configuration)
+    static auto create(WavFileConfiguration configuration,
+                       WavWriterOptions options = {})
+            -> std::optional<WavWriter>;
+
+    /**
+     * @brief Gets the writer configuration.
+     * @return The writer configuration
+     */
+    [[nodiscard]] auto get_configuration() const -> WavFileConfiguration;
+
+    /**
+     * @brief Checks whether writes bypass the page cache.
+     * @return True if the file was opened with O_DIRECT, false otherwise
+     */
+    [[nodiscard]] auto is_direct_io() const -> bool;
+
+    /**
+     * @brief Checks whether a write to the file failed.
+     * @details Covers both the file stream, including the flush when the
+     * file is closed, and O_DIRECT writes. Once an O_DIRECT block fails, no
+     * more data is written and the header sizes are not patched when
+     * closing, so the file does not claim audio it does not hold.
+     * @return True if a write failed, false otherwise
+     */
+    [[nodiscard]] auto has_write_error() const -> bool;
+
+    /**
+     * @brief Gets the hash of the samples written so far.
+     * @details The hash is updated as samples are written, so it covers
+     * exactly the data chunk payload written by this writer.
+     * @return The XXH64 digest of the encoded samples
+     */
+    [[nodiscard]] auto get_payload_hash() const -> uint64_t;
+
+    /**
+     * @brief Gets the statistics collected since the writer was opened or
+     * the statistics were reset.
+     * @details Only collected when WavWriterOptions::collectStats is set and
+     * AUDIO_FILE_TOOLS_STATS is not 0.
+     * @return The statistics, all zero when they are not collected
+     */
+    [[nodiscard]] auto get_stats() const -> WavIoStats;
+
+    /**
+     * @brief Sets the statistics back to zero.
+     */
+    auto reset_stats() -> void;
+
+    /**
+     * @brief Gets the latencies of write calls recorded since the writer was
+     * opened or the latencies were reset.
+     * @details Only recorded when WavWriterOptions::trackLatency is set. Can
+     * be called from another thread while the writer is in use.
+     * @return The count, deadline misses and percentiles, all zero when
+     * latencies are not recorded
+     */
+    [[nodiscard]] auto get_latency() const -> WavLatencySummary;
+
+    /**
+     * @brief Forgets the recorded latencies.
+     */
+    auto reset_latency() -> void;
+
+    /**
+     * @brief Public constructor that reopens an existing WAV file and
+     * continues writing at the end of its data chunk.
+     * @details The header of the existing file must match the configuration,
+     * and the data chunk must be the last chunk in the file. Only the header
+     * is read, so reopening does not depend on the size of the file.
+     * @param configuration WAV writer configuration, where the filename is
+     * the path of the existing file
+     * @return A WAV writer object if the existing file matches the
+     * configuration, std::nullopt otherwise
+     */
+    static auto open_append(WavFileConfiguration configuration)
             -> std::optional<WavWriter>;
 
     /**
@@ -70,6 +180,58 @@ public:
         write_buffer(sampleArrays.data(), count);
     }
 
+    /**
+     * @brief Writes an array of samples to the WAV file.
+     * @param sampleArrays The array of samples. The first dimension
+     * represents the channel, and the second dimension represents the sample.
+     * Unlike write(), the number of channels does not need to be known at
+     * compile time.
+     * @param count The number of samples to write
+     */
+    auto write_buffer(AllowedAudioDataType auto *const *sampleArrays,
+                      const size_t count) -> void {
+        WAV_TRACE2(write_block_start, this, count);
+        WAV_REALTIME_SCOPE();
+        const WavLatencyTimer latencyTimer(m_latency.get());
+        if (m_directFileDescriptor >= 0) {
+            write_direct(sampleArrays, count);
+        } else {
+            write_stream(sampleArrays, count);
+        }
+        WAV_TRACE5(write_block, this, count, count * m_config.blockAlign,
+                   m_config.format, m_config.bitDepth);
+    }
+
+    /**
+     * @brief Writes frames that are already encoded in the output format.
+     * @param data The interleaved, encoded frames
+     * @param byteCount The number of bytes to write, a multiple of the block
+     * alignment
+     */
+    auto write_encoded(const uint8_t *data, const size_t byteCount) -> void {
+        WAV_TRACE2(write_block_start, this, byteCount / m_config.blockAlign);
+        WAV_REALTIME_SCOPE();
+        const WavLatencyTimer latencyTimer(m_latency.get());
+        m_hasher.update(data, byteCount);
+        if (m_directFileDescriptor >= 0) {
+            stage(data, byteCount);
+        } else {
+            const WavStatsTimer timer(m_stats.get(), WavStatsPhase::IO);
+            WAV_REALTIME_BLOCKING("std::ofstream::write");
+            m_fileStream.write(reinterpret_cast<const char *>(data),
+                               static_cast<std::streamsize>(byteCount));
+            if (m_stats) {
+                m_stats->add_io_call();
+            }
+        }
+        if (m_stats) {
+            m_stats->add_data(byteCount, byteCount / m_config.blockAlign);
+        }
+        m_totalFileSize += byteCount;
+        WAV_TRACE5(write_block, this, byteCount / m_config.blockAlign,
+                   byteCount, m_config.format, m_config.bitDepth);
+    }
+
     /**
      * @brief Close the WAV file.
      */
@@ -81,7 +243,23 @@ public:
      */
     WavWriter(WavWriter &&other) noexcept :
         m_config(std::move(other.m_config)),
-        m_fileStream(std::move(other.m_fileStream)) {}
+        m_fileStream(std::move(other.m_fileStream)),
+        m_totalFileSize(other.m_totalFileSize),
+        m_headerLayout(other.m_headerLayout),
+        m_options(other.m_options),
+        m_directFileDescriptor(other.m_directFileDescriptor),
+        m_staging(std::move(other.m_staging)),
+        m_stagingSize(other.m_stagingSize),
+        m_stagingUsed(other.m_stagingUsed),
+        m_directOffset(other.m_directOffset),
+        m_writeFailed(other.m_writeFailed),
+        m_hasher(other.m_hasher),
+        m_trailingBytes(other.m_trailingBytes),
+        m_stats(std::move(other.m_stats)),
+        m_latency(std::move(other.m_latency)),
+        m_encodeBuffer(std::move(other.m_encodeBuffer)) {
+        other.m_directFileDescriptor = -1;
+    }
 
     /**
      * @brief Overloaded move assignment operator
@@ -90,8 +268,26 @@ public:
      */
     WavWriter &operator=(WavWriter &&other) noexcept {
         if (this != &other) {
+            /// Finalize and close the file this writer has open first, so
+            /// its header is patched and its descriptor is not leaked
+            close_file();
             m_config = std::move(other.m_config);
             m_fileStream = std::move(other.m_fileStream);
+            m_totalFileSize = other.m_totalFileSize;
+            m_headerLayout = other.m_headerLayout;
+            m_options = other.m_options;
+            m_directFileDescriptor = other.m_directFileDescriptor;
+            m_staging = std::move(other.m_staging);
+            m_stagingSize = other.m_stagingSize;
+            m_stagingUsed = other.m_stagingUsed;
+            m_directOffset = other.m_directOffset;
+            m_writeFailed = other.m_writeFailed;
+            m_hasher = other.m_hasher;
+            m_trailingBytes = other.m_trailingBytes;
+            m_stats = std::move(other.m_stats);
+            m_latency = std::move(other.m_latency);
+            m_encodeBuffer = std::move(other.m_encodeBuffer);
+            other.m_directFileDescriptor = -1;
         }
         return *this;
     }
@@ -105,220 +301,130 @@ private:
      * @brief Private constructor
      * @param configuration The configuration for the WAV writer
      */
-    explicit WavWriter(WavFileConfiguration configuration) :
-        m_config(std::move(configuration)) {}
-
-    auto write_to_float32(AllowedAudioDataType auto *const *sampleArrays,
-                          const size_t count) -> void {
-        using DataType = std::remove_cv_t<
-                std::remove_pointer_t<std::remove_cv_t<std::remove_pointer_t<
-                        std::decay_t<decltype(sampleArrays)>>>>>;
-        assert(m_config.bitDepth == WavBitDepth::BIT_DEPTH_32);
-        std::vector<float> interleavedSamples(count * m_config.numChannels);
-        for (size_t i = 0; i < count; ++i) {
-            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
-                /// Convert the input data type to float
-                if constexpr (std::is_same_v<DataType, float>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            sampleArrays[ch][i];
-                } else if constexpr (std::is_same_v<DataType, uint8_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_uint8_to_float(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int16_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int16_to_float(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int32_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int32_to_float(sampleArrays[ch][i]);
-                }
-            }
+    explicit WavWriter(WavFileConfiguration configuration,
+                       const WavWriterOptions options = {}) :
+        m_config(std::move(configuration)), m_options(options),
+        m_stats(make_wav_stats(options.collectStats)) {
+        if (options.trackLatency) {
+            m_latency = std::make_unique<WavLatencyHistogram>(
+                    options.deadlineNanoseconds);
         }
-        // Write interleaved samples to the file
-        write_samples(interleavedSamples);
     }
 
-    auto write_to_pcm8(AllowedAudioDataType auto *const *sampleArrays,
-                       const size_t count) -> void {
-        using DataType = std::remove_cv_t<
-                std::remove_pointer_t<std::remove_cv_t<std::remove_pointer_t<
-                        std::decay_t<decltype(sampleArrays)>>>>>;
-        // Allocate a buffer to hold interleaved samples
-        std::vector<uint8_t> interleavedSamples(count * m_config.numChannels);
-        for (size_t i = 0; i < count; ++i) {
-            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
-                /// Convert the input data type to uint8_t
-                if constexpr (std::is_same_v<DataType, float>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_float_to_uint8(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, uint8_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            sampleArrays[ch][i];
-                } else if constexpr (std::is_same_v<DataType, int16_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int16_to_uint8(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int32_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int32_to_uint8(sampleArrays[ch][i]);
-                }
+    /**
+     * @brief Encodes samples straight into the O_DIRECT staging buffer.
+     * @param sampleArrays The array of samples
+     * @param count The number of frames to write
+     */
+    template<AllowedAudioDataType T>
+    auto write_direct(const T *const *sampleArrays, const size_t count)
+            -> void {
+        std::array<const T *, UINT8_MAX> arrays{};
+        std::copy_n(sampleArrays, m_config.numChannels, arrays.begin());
+        size_t written = 0;
+        while (written < count) {
+            const size_t space =
+                    (m_stagingSize - m_stagingUsed) / m_config.blockAlign;
+            if (space == 0) {
+                flush_staging();
+                continue;
             }
-        }
-        // Write interleaved samples to the file
-        write_samples(interleavedSamples);
-    }
-
-    auto write_to_pcm16(AllowedAudioDataType auto *const *sampleArrays,
-                        const size_t count) -> void {
-        using DataType = std::remove_cv_t<
-                std::remove_pointer_t<std::remove_cv_t<std::remove_pointer_t<
-                        std::decay_t<decltype(sampleArrays)>>>>>;
-        // Allocate a buffer to hold interleaved samples
-        std::vector<int16_t> interleavedSamples(count * m_config.numChannels);
-        for (size_t i = 0; i < count; ++i) {
-            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
-                /// Convert the input data type to int16_t
-                if constexpr (std::is_same_v<DataType, float>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_float_to_int16(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, uint8_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_uint8_to_int16(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int16_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            sampleArrays[ch][i];
-                } else if constexpr (std::is_same_v<DataType, int32_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int32_to_int16(sampleArrays[ch][i]);
-                }
+            const size_t frames = std::min(space, count - written);
+            {
+                const WavStatsTimer timer(m_stats.get(),
+                                          wav_codec_phase<T>(m_config));
+                encode_frames(arrays.data(), frames, m_config,
+                              m_staging.get() + m_stagingUsed);
             }
-        }
-        // Write interleaved samples to the file
-        write_samples(interleavedSamples);
-    }
-
-    auto write_to_pcm24(AllowedAudioDataType auto *const *sampleArrays,
-                        const size_t count) -> void {
-        using DataType = std::remove_cv_t<
-                std::remove_pointer_t<std::remove_cv_t<std::remove_pointer_t<
-                        std::decay_t<decltype(sampleArrays)>>>>>;
-        // Allocate a buffer to hold interleaved samples
-        std::vector<uint8_t> interleavedSamples(count * m_config.numChannels *
-                                                3);
-        for (size_t i = 0; i < count; ++i) {
-            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
-                /// Convert the input data type to int32_t
-                int32_t sample = 0;
-                if constexpr (std::is_same_v<DataType, float>) {
-                    sample = convert_float_to_int24(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, uint8_t>) {
-                    sample = convert_uint8_to_int24(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int16_t>) {
-                    sample = convert_int16_to_int24(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int32_t>) {
-                    sample = convert_int32_to_int24(sampleArrays[ch][i]);
-                }
-                interleavedSamples[((i * m_config.numChannels + ch) * 3 + 0) *
-                                           m_config.numChannels +
-                                   ch] = static_cast<uint8_t>(sample & 0xFF);
-                interleavedSamples[((i * m_config.numChannels + ch) * 3 + 1) *
-                                           m_config.numChannels +
-                                   ch] =
-                        static_cast<uint8_t>((sample >> 8) & 0xFF);
-                interleavedSamples[((i * m_config.numChannels + ch) * 3 + 2) *
-                                           m_config.numChannels +
-                                   ch] =
-                        static_cast<uint8_t>((sample >> 16) & 0xFF);
+            m_hasher.update(m_staging.get() + m_stagingUsed,
+                            frames * m_config.blockAlign);
+            m_stagingUsed += frames * m_config.blockAlign;
+            m_totalFileSize += frames * m_config.blockAlign;
+            if (m_stats) {
+                m_stats->add_data(frames * m_config.blockAlign, frames);
             }
-        }
-        // Write interleaved samples to the file
-        write_samples(interleavedSamples, true);
-    }
-
-    auto write_to_pcm32(AllowedAudioDataType auto *const *sampleArrays,
-                        const size_t count) -> void {
-        using DataType = std::remove_cv_t<
-                std::remove_pointer_t<std::remove_cv_t<std::remove_pointer_t<
-                        std::decay_t<decltype(sampleArrays)>>>>>;
-        // Allocate a buffer to hold interleaved samples
-        std::vector<int32_t> interleavedSamples(count * m_config.numChannels);
-        for (size_t i = 0; i < count; ++i) {
             for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
-                /// Convert the input data type to int32_t
-                if constexpr (std::is_same_v<DataType, float>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_float_to_int32(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, uint8_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_uint8_to_int32(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int16_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            convert_int16_to_int32(sampleArrays[ch][i]);
-                } else if constexpr (std::is_same_v<DataType, int32_t>) {
-                    interleavedSamples[i * m_config.numChannels + ch] =
-                            sampleArrays[ch][i];
-                }
+                arrays[ch] += frames;
             }
+            written += frames;
         }
-        // Write interleaved samples to the file
-        write_samples(interleavedSamples);
     }
 
     /**
-     * @brief Writes an array of samples to the WAV file.
-     * @param sampleArrays The array of samples. The first dimension
-     * represents the channel, and the second dimension represents the sample.
-     * @param count The number of samples to write
+     * @brief Copies bytes into the O_DIRECT staging buffer, flushing it
+     * whenever it fills up.
+     * @param data The bytes
+     * @param byteCount The number of bytes
      */
-    auto write_buffer(AllowedAudioDataType auto *const *sampleArrays,
-                      const size_t count) -> void {
-        /// Float-32 output format
-        if (m_config.format == WavFormat::FLOAT) {
-            write_to_float32(sampleArrays, count);
-        } else if (m_config.format == WavFormat::PCM) {
-            switch (m_config.bitDepth) {
-                /// PCM-8 output format
-                case WavBitDepth::BIT_DEPTH_8: {
-                    write_to_pcm8(sampleArrays, count);
-                    break;
-                }
-                /// PCM-16 output format
-                case WavBitDepth::BIT_DEPTH_16: {
-                    write_to_pcm16(sampleArrays, count);
-                    break;
-                }
-                /// PCM-24 output format
-                case WavBitDepth::BIT_DEPTH_24: {
-                    write_to_pcm24(sampleArrays, count);
-                    break;
-                }
-                /// PCM-32 output format
-                case WavBitDepth::BIT_DEPTH_32: {
-                    write_to_pcm32(sampleArrays, count);
-                    break;
-                }
-            }
-        }
-    }
+    auto stage(const uint8_t *data, size_t byteCount) -> void;
 
     /**
-     * @brief Writes an array of samples to the WAV file.
-     * @tparam T The type of the samples
-     * @param formattedSamples The array of samples already formatted in the
-     * output format.
-     * @param ignoreSize Whether to ignore the size of the samples, which is
-     * used when writing PCM24 samples, since there is no native int24 datatype
+     * @brief Writes the whole sectors of the staging buffer to the file and
+     * moves the partial sector left over to the front of the buffer.
+     */
+    auto flush_staging() -> void;
+
+    /**
+     * @brief Writes sector-aligned bytes to the O_DIRECT file, retrying
+     * without O_DIRECT if the filesystem rejects them.
+     * @param data The bytes to write
+     * @param byteCount The number of bytes to write
+     * @param offset The offset in the file
+     * @return True if every byte was written, false otherwise
+     */
+    auto write_direct_block(const uint8_t *data, size_t byteCount,
+                            uint64_t offset) -> bool;
+
+    /**
+     * @brief Writes the unaligned tail, trims the file to its real size and
+     * patches the header through a buffered descriptor.
+     */
+    auto finalize_direct() -> void;
+
+    /**
+     * @brief Builds the chunks written after the data chunk when closing.
+     * @return The bytes of the chunks, including the pad byte of the data
+     * chunk
+     */
+    auto trailing_chunks() -> std::string;
+
+    /**
+     * @brief Encodes samples into the reused encode buffer and writes them
+     * to the file stream.
+     * @details The buffer only grows, so once it holds the largest block
+     * written, writing does not allocate.
+     * @param sampleArrays The array of samples
+     * @param count The number of frames to write
      */
     template<AllowedAudioDataType T>
-    auto write_samples(const std::vector<T> &formattedSamples,
-                       const bool ignoreSize = false) -> void {
-        m_fileStream.write(
-                reinterpret_cast<const char *>(formattedSamples.data()),
-                static_cast<std::streamsize>(formattedSamples.size() *
-                                             sizeof(T)));
-        if (ignoreSize) {
-            m_totalFileSize += formattedSamples.size();
-        } else {
-            m_totalFileSize += formattedSamples.size() * sizeof(T);
+    auto write_stream(const T *const *sampleArrays, const size_t count)
+            -> void {
+        const size_t byteCount = count * m_config.blockAlign;
+        if (m_encodeBuffer.size() < byteCount) {
+            m_encodeBuffer.resize(byteCount);
+            if (m_stats) {
+                m_stats->add_allocations();
+            }
+        }
+        {
+            const WavStatsTimer timer(m_stats.get(),
+                                      wav_codec_phase<T>(m_config));
+            encode_frames(sampleArrays, count, m_config,
+                          m_encodeBuffer.data());
+        }
+        {
+            const WavStatsTimer timer(m_stats.get(), WavStatsPhase::IO);
+            WAV_REALTIME_BLOCKING("std::ofstream::write");
+            m_fileStream.write(
+                    reinterpret_cast<const char *>(m_encodeBuffer.data()),
+                    static_cast<std::streamsize>(byteCount));
+        }
+        if (m_stats) {
+            m_stats->add_io_call();
+            m_stats->add_data(byteCount, count);
         }
+        m_hasher.update(m_encodeBuffer.data(), byteCount);
+        m_totalFileSize += byteCount;
     }
 
     /**
@@ -327,6 +433,13 @@ private:
      */
     auto open_file() -> bool;
 
+    /**
+     * @brief Opens an existing WAV file for appending.
+     * @return True if the file was opened successfully and its header matches
+     * the configuration, false otherwise
+     */
+    auto open_existing_file() -> bool;
+
     /**
      * @brief Write the WAV file header.
      */
@@ -345,6 +458,52 @@ private:
 
     /** The total file size */
     uint32_t m_totalFileSize = 0;
+
+    /** The offsets of the header fields updated when finalizing */
+    WavHeaderLayout m_headerLayout = {};
+
+    /** Frees memory from std::aligned_alloc */
+    struct AlignedDeleter {
+        auto operator()(uint8_t *buffer) const -> void { std::free(buffer); }
+    };
+
+    /** The I/O mode */
+    WavWriterOptions m_options = {};
+
+    /** The file descriptor opened with O_DIRECT, or -1 when writing through
+     * the file stream */
+    int m_directFileDescriptor = -1;
+
+    /** The sector-aligned staging buffer used with O_DIRECT */
+    std::unique_ptr<uint8_t, AlignedDeleter> m_staging;
+
+    /** The size of the staging buffer */
+    size_t m_stagingSize = 0;
+
+    /** The number of bytes used in the staging buffer */
+    size_t m_stagingUsed = 0;
+
+    /** The file offset of the start of the staging buffer */
+    uint64_t m_directOffset = 0;
+
+    /** Whether a write failed, see has_write_error() */
+    bool m_writeFailed = false;
+
+    /** The hash of the data chunk payload */
+    WavHasher m_hasher;
+
+    /** The number of bytes written after the data chunk */
+    uint32_t m_trailingBytes = 0;
+
+    /** The statistics, or nullptr when they are not collected */
+    std::unique_ptr<WavStatsCounters> m_stats;
+
+    /** The latencies of write calls, or nullptr when they are not
+     * recorded */
+    std::unique_ptr<WavLatencyHistogram> m_latency;
+
+    /** The buffer reused to encode samples for the file stream */
+    std::vector<uint8_t> m_encodeBuffer;
 };
 
 #endif // WAV_WRITER_H
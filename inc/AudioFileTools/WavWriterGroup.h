@@ -0,0 +1,199 @@
+/// WavWriterGroup.h
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef WAV_WRITER_GROUP_H
+#define WAV_WRITER_GROUP_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "WavConfiguration.h"
+#include "WavConversion.h"
+#include "WavRealtime.h"
+#include "WavThreadPool.h"
+#include "WavWriter.h"
+
+/** Options for a group of WAV writers */
+struct WavWriterGroupOptions {
+    /** The number of I/O threads */
+    size_t numThreads = 2;
+    /** The upper bound on the buffers held by all files of the group */
+    size_t maxBufferedBytes = 64 << 20;
+};
+
+/**
+ * @brief Writes the channels of one multichannel stream to many WAV files.
+ * @details Each block handed to write() is split by channel and encoded into
+ * a buffer per file. Full buffers are flushed on a small pool of I/O threads
+ * while the caller fills a second buffer, so the caller only blocks when a
+ * file's previous flush has not finished yet. Both buffers of every file are
+ * allocated up front and share the group's memory budget, so flushes are
+ * as large as the budget allows.
+ */
+class WavWriterGroup {
+public:
+    /**
+     * @brief Public constructor that creates the WAV files.
+     * @param configurations The configuration of each file. The channels of
+     * the input stream are assigned to the files in order.
+     * @param options The group options
+     * @return A writer group object if every file was created, std::nullopt
+     * otherwise
+     */
+    static auto create(const std::vector<WavFileConfiguration> &configurations,
+                       WavWriterGroupOptions options = {})
+            -> std::optional<WavWriterGroup>;
+
+    /**
+     * @brief Public destructor
+     */
+    ~WavWriterGroup();
+
+    /**
+     * @brief Writes a block of the multichannel stream.
+     * @param sampleArrays The array of samples. The first dimension
+     * represents the channel, across all files, and the second dimension
+     * represents the sample.
+     * @param count The number of frames to write
+     */
+    template<AllowedAudioDataType T>
+    auto write_buffer(const T *const *sampleArrays, const size_t count)
+            -> void {
+        WAV_REALTIME_SCOPE();
+        size_t channel = 0;
+        for (const auto &track : m_tracks) {
+            const size_t blockAlign = track->config.blockAlign;
+            std::array<const T *, UINT8_MAX> trackArrays{};
+            for (size_t ch = 0; ch < track->config.numChannels; ++ch) {
+                trackArrays[ch] = sampleArrays[channel + ch];
+            }
+            size_t frame = 0;
+            while (frame < count) {
+                const size_t space =
+                        (track->filling.size() - track->filled) / blockAlign;
+                const size_t frames = std::min(space, count - frame);
+                encode_frames(trackArrays.data(), frames, track->config,
+                              track->filling.data() + track->filled);
+                track->filled += frames * blockAlign;
+                frame += frames;
+                for (size_t ch = 0; ch < track->config.numChannels; ++ch) {
+                    trackArrays[ch] += frames;
+                }
+                if (track->filled + blockAlign > track->filling.size()) {
+                    flush_track(*track);
+                }
+            }
+            channel += track->config.numChannels;
+        }
+    }
+
+    /**
+     * @brief Flushes the remaining buffers and closes every file.
+     */
+    auto close() -> void;
+
+    /**
+     * @brief Gets the number of files in the group.
+     * @return The number of files
+     */
+    [[nodiscard]] auto size() const -> size_t;
+
+    /**
+     * @brief Gets the total number of channels across all files.
+     * @return The number of channels
+     */
+    [[nodiscard]] auto num_channels() const -> size_t;
+
+    /**
+     * @brief Overloaded move constructor
+     * @param other The other writer group object
+     */
+    WavWriterGroup(WavWriterGroup &&other) noexcept :
+        m_tracks(std::move(other.m_tracks)), m_pool(std::move(other.m_pool)) {}
+
+    /** Delete copy constructor and assignment operators */
+    WavWriterGroup(const WavWriterGroup &) = delete;
+    WavWriterGroup &operator=(const WavWriterGroup &) = delete;
+    WavWriterGroup &operator=(WavWriterGroup &&) = delete;
+
+private:
+    /** A file of the group and its buffers */
+    struct Track {
+        /**
+         * @brief Constructor that allocates both buffers.
+         * @param configuration The configuration of the file
+         * @param fileWriter The writer of the file
+         * @param bufferBytes The size of each buffer
+         */
+        Track(WavFileConfiguration configuration, WavWriter fileWriter,
+              const size_t bufferBytes) :
+            config(std::move(configuration)), writer(std::move(fileWriter)),
+            filling(bufferBytes), flushing(bufferBytes) {}
+
+        /** The configuration of the file */
+        WavFileConfiguration config;
+        /** The writer, only used by the flush in flight */
+        WavWriter writer;
+        /** The buffer being filled by write_buffer() */
+        std::vector<uint8_t> filling;
+        /** The number of bytes used in the filling buffer */
+        size_t filled = 0;
+        /** The buffer being written by the flush in flight */
+        std::vector<uint8_t> flushing;
+        /** Guards inFlight */
+        std::mutex mutex;
+        /** Signalled when the flush in flight finishes */
+        std::condition_variable flushed;
+        /** Whether a flush of this file is in flight */
+        bool inFlight = false;
+    };
+
+    /**
+     * @brief Private constructor
+     */
+    WavWriterGroup() = default;
+
+    /**
+     * @brief Hands a file's filling buffer to the I/O pool, once its previous
+     * flush has finished.
+     * @param track The file
+     */
+    auto flush_track(Track &track) -> void;
+
+    /** The files of the group */
+    std::vector<std::unique_ptr<Track>> m_tracks;
+
+    /** The pool running the flushes */
+    std::unique_ptr<WavThreadPool> m_pool;
+};
+
+#endif // WAV_WRITER_GROUP_H
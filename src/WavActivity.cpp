@@ -0,0 +1,408 @@
+/// WavActivity.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavActivity.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+#include <AudioFileTools/WavConfiguration.h>
+#include <AudioFileTools/WavHeader.h>
+
+namespace {
+/**
+ * @brief Peak level of a window of raw frames, in the file's own domain.
+ * @details 8-bit samples are unsigned around 128 and 24-bit samples are
+ * sign-extended, so every PCM depth compares as an integer.
+ */
+auto window_peak(const uint8_t *raw, const size_t samples,
+                 const WavFileConfiguration &config) -> double {
+    if (config.format == WavFormat::FLOAT) {
+        float peak = 0.0f;
+        for (size_t i = 0; i < samples; ++i) {
+            float sample;
+            std::memcpy(&sample, raw + i * 4, 4);
+            peak = std::max(peak, std::abs(sample));
+        }
+        return peak;
+    }
+    int64_t peak = 0;
+    switch (config.bitDepth) {
+        case WavBitDepth::BIT_DEPTH_8:
+            for (size_t i = 0; i < samples; ++i) {
+                peak = std::max<int64_t>(peak, std::abs(raw[i] - 128));
+            }
+            break;
+        case WavBitDepth::BIT_DEPTH_16:
+            for (size_t i = 0; i < samples; ++i) {
+                int16_t sample;
+                std::memcpy(&sample, raw + i * 2, 2);
+                peak = std::max<int64_t>(peak, std::abs(sample));
+            }
+            break;
+        case WavBitDepth::BIT_DEPTH_24:
+            for (size_t i = 0; i < samples; ++i) {
+                const uint8_t *bytes = raw + i * 3;
+                const int32_t sample =
+                        static_cast<int32_t>((bytes[0] << 8) | (bytes[1] << 16) |
+                                             (bytes[2] << 24)) >>
+                        8;
+                peak = std::max<int64_t>(peak, std::abs(sample));
+            }
+            break;
+        case WavBitDepth::BIT_DEPTH_32:
+            for (size_t i = 0; i < samples; ++i) {
+                int32_t sample;
+                std::memcpy(&sample, raw + i * 4, 4);
+                peak = std::max<int64_t>(peak,
+                                         std::abs(static_cast<int64_t>(sample)));
+            }
+            break;
+    }
+    return static_cast<double>(peak);
+}
+
+/**
+ * @brief Converts a level in dBFS to the file's own sample domain.
+ * @details PCM thresholds never fall below one step, since 8-bit silence
+ * is written as 127 rather than the 128 midpoint.
+ */
+auto native_threshold(const float thresholdDb,
+                      const WavFileConfiguration &config) -> double {
+    const double linear = std::pow(10.0, thresholdDb / 20.0);
+    if (config.format == WavFormat::FLOAT) {
+        return linear;
+    }
+    const int bits = static_cast<int>(config.bitDepth);
+    return std::max(1.0, std::floor(linear * std::ldexp(1.0, bits - 1)));
+}
+
+/**
+ * @brief Appends a little-endian integer to a byte string.
+ */
+template<typename T>
+auto append_le(std::string &bytes, const T value) -> void {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+} // namespace
+
+/**
+ * @brief Finds the active regions of a WAV file.
+ * @param filename The filename of the WAV file
+ * @param options The detection options
+ * @return The active regions in order, or std::nullopt if the file is not a
+ * valid WAV file
+ */
+auto detect_wav_activity(const std::string &filename,
+                         const WavActivityOptions &options)
+        -> std::optional<std::vector<WavActivityRegion>> {
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return std::nullopt;
+    }
+    WavFileConfiguration config;
+    if (!read_wav_header(input, config)) {
+        return std::nullopt;
+    }
+    const double threshold = native_threshold(options.thresholdDb, config);
+    const size_t windowFrames = std::max<size_t>(1, options.windowFrames);
+    const size_t totalFrames = config.num_samples();
+    /// Stream many windows per read
+    const size_t blockWindows =
+            std::max<size_t>(1, (1 << 20) / (windowFrames * config.blockAlign));
+    std::vector<uint8_t> raw(blockWindows * windowFrames * config.blockAlign);
+
+    std::vector<WavActivityRegion> regions;
+    std::optional<size_t> regionStart;
+    size_t regionEnd = 0;
+    const auto closeRegion = [&] {
+        if (regionStart && regionEnd - *regionStart >= options.minActiveFrames) {
+            regions.push_back(
+                    {.start = static_cast<uint32_t>(*regionStart),
+                     .length = static_cast<uint32_t>(regionEnd - *regionStart)});
+        }
+        regionStart.reset();
+    };
+
+    size_t frame = 0;
+    while (frame < totalFrames) {
+        const size_t frames =
+                std::min(totalFrames - frame, blockWindows * windowFrames);
+        input.read(reinterpret_cast<char *>(raw.data()),
+                   static_cast<std::streamsize>(frames * config.blockAlign));
+        const size_t framesRead =
+                static_cast<size_t>(input.gcount()) / config.blockAlign;
+        for (size_t w = 0; w < framesRead; w += windowFrames) {
+            const size_t n = std::min(windowFrames, framesRead - w);
+            const double peak =
+                    window_peak(raw.data() + w * config.blockAlign,
+                                n * config.numChannels, config);
+            const size_t start = frame + w;
+            if (peak <= threshold) {
+                continue;
+            }
+            /// Bridge silences shorter than the minimum
+            if (regionStart && start - regionEnd >= options.minSilenceFrames) {
+                closeRegion();
+            }
+            if (!regionStart) {
+                regionStart = start;
+            }
+            regionEnd = start + n;
+        }
+        frame += framesRead;
+        if (framesRead < frames) {
+            break;
+        }
+    }
+    closeRegion();
+    return regions;
+}
+
+namespace {
+/** A top-level chunk found while walking a file */
+struct ChunkPosition {
+    /** The offset of the chunk header */
+    uint64_t offset;
+    /** Whether the chunk is a 'cue ' or 'LIST' 'adtl' index chunk */
+    bool index;
+};
+
+/**
+ * @brief Lists the top-level chunks of a RIFF file.
+ * @param file The file
+ * @param fileSize The size of the file
+ * @return The chunks that fit in the file, in order
+ */
+auto find_chunks(std::istream &file, const uint64_t fileSize)
+        -> std::vector<ChunkPosition> {
+    std::vector<ChunkPosition> chunks;
+    uint64_t offset = 12;
+    while (offset + 8 <= fileSize) {
+        std::array<char, 4> chunkId{};
+        std::array<char, 4> listType{};
+        uint32_t chunkSize = 0;
+        file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        file.read(chunkId.data(), 4);
+        file.read(reinterpret_cast<char *>(&chunkSize), 4);
+        if (!file) {
+            break;
+        }
+        if (std::memcmp(chunkId.data(), "LIST", 4) == 0 && chunkSize >= 4) {
+            file.read(listType.data(), 4);
+        }
+        const bool index =
+                std::memcmp(chunkId.data(), "cue ", 4) == 0 ||
+                (std::memcmp(chunkId.data(), "LIST", 4) == 0 &&
+                 std::memcmp(listType.data(), "adtl", 4) == 0);
+        chunks.push_back({.offset = offset, .index = index});
+        offset += 8 + ((static_cast<uint64_t>(chunkSize) + 1) & ~1ull);
+    }
+    file.clear();
+    return chunks;
+}
+} // namespace
+
+/**
+ * @brief Stores regions in a WAV file as a 'cue ' chunk and a 'LIST' chunk
+ * of 'adtl' labelled text entries.
+ * @param filename The filename of the WAV file
+ * @param regions The regions
+ * @return True if the chunks were written, false otherwise
+ */
+auto write_wav_activity_index(const std::string &filename,
+                              const std::vector<WavActivityRegion> &regions)
+        -> bool {
+    std::fstream file(filename,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) {
+        return false;
+    }
+    WavFileConfiguration config;
+    if (!read_wav_header(file, config)) {
+        return false;
+    }
+
+    std::string chunks;
+    chunks.append("cue ", 4);
+    append_le<uint32_t>(chunks, static_cast<uint32_t>(4 + 24 * regions.size()));
+    append_le<uint32_t>(chunks, static_cast<uint32_t>(regions.size()));
+    for (size_t i = 0; i < regions.size(); ++i) {
+        append_le<uint32_t>(chunks, static_cast<uint32_t>(i + 1));
+        append_le<uint32_t>(chunks, regions[i].start);
+        chunks.append("data", 4);
+        append_le<uint32_t>(chunks, 0);
+        append_le<uint32_t>(chunks, 0);
+        append_le<uint32_t>(chunks, regions[i].start);
+    }
+    chunks.append("LIST", 4);
+    append_le<uint32_t>(chunks, static_cast<uint32_t>(4 + 28 * regions.size()));
+    chunks.append("adtl", 4);
+    for (size_t i = 0; i < regions.size(); ++i) {
+        chunks.append("ltxt", 4);
+        append_le<uint32_t>(chunks, 20);
+        append_le<uint32_t>(chunks, static_cast<uint32_t>(i + 1));
+        append_le<uint32_t>(chunks, regions[i].length);
+        chunks.append("rgn ", 4);
+        append_le<uint64_t>(chunks, 0);
+    }
+
+    /// Drop the index left by an earlier call, so re-indexing replaces it
+    /// rather than merging with it. An index at the end of the file is cut
+    /// off, and one followed by other chunks is renamed to 'JUNK', which
+    /// readers skip.
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    const auto existing = find_chunks(file, fileSize);
+    size_t trailing = existing.size();
+    while (trailing > 0 && existing[trailing - 1].index) {
+        --trailing;
+    }
+    for (size_t i = 0; i < trailing; ++i) {
+        if (existing[i].index) {
+            file.seekp(static_cast<std::streamoff>(existing[i].offset),
+                       std::ios::beg);
+            file.write("JUNK", 4);
+        }
+    }
+    if (trailing < existing.size()) {
+        fileSize = existing[trailing].offset;
+        file.close();
+        std::error_code error;
+        std::filesystem::resize_file(filename, fileSize, error);
+        if (error) {
+            return false;
+        }
+        file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file) {
+            return false;
+        }
+    }
+
+    /// Chunks start on even offsets, so pad a file that ends on an odd one
+    file.seekp(0, std::ios::end);
+    if (fileSize % 2 != 0) {
+        file.put('\0');
+        ++fileSize;
+    }
+    file.write(chunks.data(), static_cast<std::streamsize>(chunks.size()));
+    const auto riffSize =
+            static_cast<uint32_t>(fileSize + chunks.size() - 8);
+    file.seekp(4, std::ios::beg);
+    file.write(reinterpret_cast<const char *>(&riffSize), 4);
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief Reads the regions stored by write_wav_activity_index().
+ * @param filename The filename of the WAV file
+ * @return The regions in order, or std::nullopt if the file has no index
+ */
+auto read_wav_activity_index(const std::string &filename)
+        -> std::optional<std::vector<WavActivityRegion>> {
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return std::nullopt;
+    }
+    std::map<uint32_t, uint32_t> starts;
+    std::map<uint32_t, uint32_t> lengths;
+    bool foundCue = false;
+    input.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(input.tellg());
+    input.seekg(12, std::ios::beg);
+    while (input) {
+        std::array<char, 4> chunkId{};
+        uint32_t chunkSize = 0;
+        input.read(chunkId.data(), 4);
+        input.read(reinterpret_cast<char *>(&chunkSize), 4);
+        if (!input) {
+            break;
+        }
+        const auto position = static_cast<uint64_t>(input.tellg());
+        const auto next = static_cast<std::streamoff>(position) +
+                          ((chunkSize + 1) & ~1u);
+        /// Only the index chunks are loaded, and never past the end of the
+        /// file, so a large data chunk or a corrupt size costs nothing
+        const auto read_payload = [&] {
+            std::vector<char> payload(
+                    std::min<uint64_t>(chunkSize, fileSize - position));
+            input.read(payload.data(),
+                       static_cast<std::streamsize>(payload.size()));
+            return payload;
+        };
+        if (std::memcmp(chunkId.data(), "cue ", 4) == 0) {
+            const auto payload = read_payload();
+            chunkSize = static_cast<uint32_t>(payload.size());
+            uint32_t count = 0;
+            std::memcpy(&count, payload.data(), std::min<size_t>(4, chunkSize));
+            for (uint32_t i = 0; i < count && 4 + (i + 1) * 24 <= chunkSize;
+                 ++i) {
+                uint32_t id, start;
+                std::memcpy(&id, payload.data() + 4 + i * 24, 4);
+                std::memcpy(&start, payload.data() + 4 + i * 24 + 20, 4);
+                starts[id] = start;
+            }
+            foundCue = true;
+        } else if (std::memcmp(chunkId.data(), "LIST", 4) == 0 &&
+                   chunkSize >= 4) {
+            const auto payload = read_payload();
+            chunkSize = static_cast<uint32_t>(payload.size());
+            if (chunkSize >= 4 &&
+                std::memcmp(payload.data(), "adtl", 4) == 0) {
+                size_t offset = 4;
+                while (offset + 8 <= chunkSize) {
+                    uint32_t size;
+                    std::memcpy(&size, payload.data() + offset + 4, 4);
+                    if (std::memcmp(payload.data() + offset, "ltxt", 4) == 0 &&
+                        size >= 8 && offset + 8 + size <= chunkSize) {
+                        uint32_t id, length;
+                        std::memcpy(&id, payload.data() + offset + 8, 4);
+                        std::memcpy(&length, payload.data() + offset + 12, 4);
+                        lengths[id] = length;
+                    }
+                    offset += 8 + ((size + 1) & ~1u);
+                }
+            }
+        }
+        input.seekg(next, std::ios::beg);
+    }
+    if (!foundCue) {
+        return std::nullopt;
+    }
+    std::vector<WavActivityRegion> regions;
+    for (const auto &[id, start] : starts) {
+        const auto length = lengths.find(id);
+        if (length != lengths.end()) {
+            regions.push_back({.start = start, .length = length->second});
+        }
+    }
+    std::ranges::sort(regions, {}, &WavActivityRegion::start);
+    return regions;
+}
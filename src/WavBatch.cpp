@@ -0,0 +1,136 @@
+/// WavBatch.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavBatch.h>
+
+#include <algorithm>
+
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+namespace {
+/**
+ * @brief Streams the samples of a reader into a writer.
+ * @tparam T The intermediate sample type
+ * @param reader The reader
+ * @param writer The writer
+ * @param numChannels The number of channels
+ * @param totalFrames The number of frames in the input
+ * @param blockBytes The memory available to the job
+ * @return The number of frames converted
+ */
+template<AllowedAudioDataType T>
+auto stream_samples(const WavReader &reader, WavWriter &writer,
+                    const size_t numChannels, const uint32_t totalFrames,
+                    const size_t blockBytes) -> uint64_t {
+    /// Budget for the intermediate samples plus the raw input and output
+    /// buffers, each at most four bytes per sample
+    const size_t bytesPerFrame = numChannels * (sizeof(T) + 8);
+    const size_t blockFrames = std::max<size_t>(1, blockBytes / bytesPerFrame);
+    std::vector<std::vector<T>> samples(numChannels,
+                                        std::vector<T>(blockFrames));
+    std::vector<T *> sampleArrays(numChannels);
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        sampleArrays[ch] = samples[ch].data();
+    }
+    uint64_t frame = 0;
+    while (frame < totalFrames) {
+        const size_t framesRead =
+                reader.read_at(frame, blockFrames, sampleArrays.data());
+        if (framesRead == 0) {
+            break;
+        }
+        writer.write_buffer(sampleArrays.data(), framesRead);
+        frame += framesRead;
+    }
+    return frame;
+}
+} // namespace
+
+/**
+ * @brief Public constructor that starts the worker threads.
+ * @param options The batch conversion options
+ */
+WavBatchConverter::WavBatchConverter(const WavBatchOptions options) :
+    m_options(options), m_pool(options.numThreads) {}
+
+/**
+ * @brief Runs a list of conversion jobs and waits for them to finish.
+ * @param jobs The conversion jobs
+ * @return The outcome of each job, in the same order as the jobs
+ */
+auto WavBatchConverter::convert(const std::vector<WavBatchJob> &jobs)
+        -> std::vector<WavBatchResult> {
+    std::vector<WavBatchResult> results(jobs.size());
+    const auto submitted = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        m_pool.submit([this, &jobs, &results, submitted, i] {
+            results[i].queueTime =
+                    std::chrono::steady_clock::now() - submitted;
+            run_job(jobs[i], results[i]);
+        });
+    }
+    m_pool.wait();
+    return results;
+}
+
+/**
+ * @brief Runs a single conversion job.
+ * @param job The conversion job
+ * @param result The outcome of the job
+ */
+auto WavBatchConverter::run_job(const WavBatchJob &job,
+                                WavBatchResult &result) const -> void {
+    const auto start = std::chrono::steady_clock::now();
+    auto reader = WavReader::create(job.input);
+    if (reader) {
+        const auto input = reader->get_configuration();
+        if (input.numChannels == job.output.numChannels &&
+            input.sampleRate == job.output.sampleRate) {
+            auto writer = WavWriter::create(job.output);
+            if (writer) {
+                /// Convert through int32 between PCM formats so no precision
+                /// is lost, and through float otherwise
+                const size_t blockBytes =
+                        m_options.maxInFlightBytes / m_pool.size();
+                const uint32_t totalFrames = input.num_samples();
+                if (input.format == WavFormat::PCM &&
+                    job.output.format == WavFormat::PCM) {
+                    result.frames = stream_samples<int32_t>(
+                            *reader, *writer, input.numChannels, totalFrames,
+                            blockBytes);
+                } else {
+                    result.frames = stream_samples<float>(
+                            *reader, *writer, input.numChannels, totalFrames,
+                            blockBytes);
+                }
+                writer->close_file();
+                result.success = result.frames == totalFrames &&
+                                 !writer->has_write_error();
+            }
+        }
+    }
+    result.runTime = std::chrono::steady_clock::now() - start;
+}
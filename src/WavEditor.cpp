@@ -0,0 +1,146 @@
+/// WavEditor.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavEditor.h>
+
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Public constructor that opens an existing WAV file for editing.
+ * @param filename The filename of the WAV file
+ * @return A WAV editor object if the file is a valid WAV file, std::nullopt
+ * otherwise
+ */
+auto WavEditor::create(const std::string &filename)
+        -> std::optional<WavEditor> {
+    auto obj = WavEditor(filename);
+    if (!obj.open_file()) {
+        return std::nullopt;
+    }
+    return obj;
+}
+
+/**
+ * @brief Public destructor
+ */
+WavEditor::~WavEditor() {
+    if (m_fileDescriptor >= 0) {
+        close_file();
+    }
+}
+
+/**
+ * @brief Close the WAV file.
+ */
+auto WavEditor::close_file() -> void {
+    if (m_fileDescriptor < 0) {
+        return;
+    }
+    ::close(m_fileDescriptor);
+    m_fileDescriptor = -1;
+}
+
+/**
+ * @brief Gets the editor configuration.
+ * @return The editor configuration
+ */
+auto WavEditor::get_configuration() -> WavFileConfiguration { return m_config; }
+
+/**
+ * @brief Opens the WAV file for reading and writing.
+ * @return True if the file was opened successfully, false otherwise
+ */
+auto WavEditor::open_file() -> bool {
+    std::ifstream input(m_config.filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return false;
+    }
+    const auto layout = read_wav_header(input, m_config);
+    if (!layout) {
+        return false;
+    }
+    m_headerLayout = *layout;
+    /// Refuse truncated files, since touching a mapped page past the end of
+    /// the file raises SIGBUS
+    input.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(input.tellg());
+    if (fileSize < m_headerLayout.dataOffset + m_config.dataChunkSize) {
+        return false;
+    }
+    m_fileDescriptor = ::open(m_config.filename.c_str(), O_RDWR);
+    return m_fileDescriptor >= 0;
+}
+
+/**
+ * @brief Maps the pages covering a range of frames into memory.
+ * @param frame The index of the first frame
+ * @param count The number of frames
+ * @return A pointer to the first byte of the first frame, or nullptr if the
+ * range is invalid or could not be mapped
+ */
+auto WavEditor::map_frames(const size_t frame, const size_t count)
+        -> uint8_t * {
+    /// Written so that a huge count cannot wrap around past the check
+    const size_t numFrames = m_config.num_samples();
+    if (m_fileDescriptor < 0 || frame > numFrames ||
+        count > numFrames - frame) {
+        return nullptr;
+    }
+    /// mmap offsets must be page aligned, so map from the start of the page
+    /// holding the first frame
+    static const auto pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    const uint64_t start =
+            m_headerLayout.dataOffset + frame * m_config.blockAlign;
+    const uint64_t mapStart = start - start % pageSize;
+    const uint64_t length = start - mapStart + count * m_config.blockAlign;
+    void *mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           m_fileDescriptor, static_cast<off_t>(mapStart));
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    m_mapping = mapping;
+    m_mappingLength = length;
+    return static_cast<uint8_t *>(mapping) + (start - mapStart);
+}
+
+/**
+ * @brief Unmaps the pages mapped by map_frames().
+ * @return True if the pages were scheduled for write-back and unmapped,
+ * false otherwise
+ */
+auto WavEditor::unmap_frames() -> bool {
+    if (m_mapping == nullptr) {
+        return false;
+    }
+    const bool synced = ::msync(m_mapping, m_mappingLength, MS_ASYNC) == 0;
+    const bool unmapped = ::munmap(m_mapping, m_mappingLength) == 0;
+    m_mapping = nullptr;
+    m_mappingLength = 0;
+    return synced && unmapped;
+}
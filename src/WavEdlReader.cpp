@@ -0,0 +1,208 @@
+/// WavEdlReader.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavEdlReader.h>
+
+#include <algorithm>
+
+/**
+ * @brief Public constructor that lays out the regions on the timeline.
+ * @param regions The regions, in playback order
+ * @param sampleRate The sample rate of every source
+ * @param numChannels The number of channels of every source
+ * @return An edit list reader object if the regions are valid, std::nullopt
+ * otherwise
+ */
+auto WavEdlReader::create(std::vector<WavEdlRegion> regions,
+                          const WavSampleRate sampleRate,
+                          const uint8_t numChannels)
+        -> std::optional<WavEdlReader> {
+    if (numChannels == 0) {
+        return std::nullopt;
+    }
+    auto obj = WavEdlReader();
+    obj.m_config.sampleRate = sampleRate;
+    obj.m_config.numChannels = numChannels;
+    obj.m_config.bitDepth = WavBitDepth::BIT_DEPTH_32;
+    obj.m_config.format = WavFormat::FLOAT;
+    obj.m_config.blockAlign = static_cast<uint16_t>(numChannels * 4);
+    size_t position = 0;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const size_t crossfade = regions[i].crossfade;
+        /// A crossfade cannot reach into the other crossfade of either region
+        if (crossfade > regions[i].length) {
+            return std::nullopt;
+        }
+        if (i == 0) {
+            if (crossfade > 0) {
+                return std::nullopt;
+            }
+        } else {
+            PlacedRegion &previous = obj.m_regions.back();
+            if (crossfade >
+                previous.region.length - previous.region.crossfade) {
+                return std::nullopt;
+            }
+            previous.fadeOut = crossfade;
+        }
+        position -= crossfade;
+        obj.m_regions.push_back({.region = std::move(regions[i]),
+                                 .start = position});
+        position += obj.m_regions.back().region.length;
+    }
+    obj.m_numFrames = position;
+    obj.m_failed.resize(obj.m_regions.size());
+    obj.m_mix.resize(numChannels);
+    obj.m_scratch.resize(numChannels);
+    obj.m_scratchArrays.resize(numChannels);
+    return obj;
+}
+
+/**
+ * @brief Gets the configuration of the composite stream.
+ * @return The configuration, as 32-bit float with an empty filename
+ */
+auto WavEdlReader::get_configuration() -> WavFileConfiguration {
+    auto config = m_config;
+    config.dataChunkSize =
+            static_cast<uint32_t>(m_numFrames * m_config.blockAlign);
+    return config;
+}
+
+/**
+ * @brief Gets the length of the timeline.
+ * @return The number of frames
+ */
+auto WavEdlReader::num_frames() const -> size_t { return m_numFrames; }
+
+/**
+ * @brief Gets the number of regions that played as silence because their
+ * source could not be used.
+ * @return The number of failed regions
+ */
+auto WavEdlReader::failed_regions() const -> size_t {
+    return std::ranges::count(m_failed, true);
+}
+
+/**
+ * @brief Moves the position used by read() and read_into().
+ * @param frame The index of the next frame to read
+ * @return True if the frame is within the timeline, false otherwise
+ */
+auto WavEdlReader::seek_frame(const size_t frame) -> bool {
+    if (frame > m_numFrames) {
+        return false;
+    }
+    m_cursor = frame;
+    return true;
+}
+
+/**
+ * @brief Gets the position used by read() and read_into().
+ * @return The index of the next frame to read
+ */
+auto WavEdlReader::tell_frame() const -> size_t { return m_cursor; }
+
+/**
+ * @brief Mixes the regions overlapping the next frames into the mix buffers.
+ * @param count The number of frames to mix
+ * @return The number of frames mixed
+ */
+auto WavEdlReader::mix(const size_t count) -> size_t {
+    const size_t frames = std::min(count, m_numFrames - m_cursor);
+    const size_t begin = m_cursor;
+    const size_t end = begin + frames;
+    for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+        m_mix[ch].assign(frames, 0.0f);
+        m_scratch[ch].resize(frames);
+        m_scratchArrays[ch] = m_scratch[ch].data();
+    }
+
+    /// Skip the regions that end before the range
+    auto it = std::ranges::upper_bound(
+            m_regions, begin, {}, [](const PlacedRegion &placed) {
+                return placed.start + placed.region.length;
+            });
+    for (; it != m_regions.end() && it->start < end; ++it) {
+        const WavEdlRegion &region = it->region;
+        const size_t overlapBegin = std::max(begin, it->start);
+        const size_t overlapEnd = std::min(end, it->start + region.length);
+        const size_t offset = overlapBegin - it->start;
+        const size_t n = overlapEnd - overlapBegin;
+        const WavReader *reader = source(region.filename);
+        const size_t index = it - m_regions.begin();
+        if (reader == nullptr) {
+            m_failed[index] = true;
+            continue;
+        }
+        const size_t framesRead = reader->read_at(region.sourceStart + offset,
+                                                  n, m_scratchArrays.data());
+        if (framesRead < n) {
+            m_failed[index] = true;
+        }
+
+        /// Equal-gain crossfades: within an overlap, the weights of the
+        /// outgoing and incoming regions sum to one
+        const size_t fadeIn = region.crossfade;
+        const size_t fadeOutStart = region.length - it->fadeOut;
+        for (size_t i = 0; i < framesRead; ++i) {
+            const size_t k = offset + i;
+            float weight = region.gain;
+            if (k < fadeIn) {
+                weight *= static_cast<float>(k + 1) /
+                          static_cast<float>(fadeIn + 1);
+            } else if (k >= fadeOutStart) {
+                weight *= 1.0f - static_cast<float>(k - fadeOutStart + 1) /
+                                         static_cast<float>(it->fadeOut + 1);
+            }
+            const size_t out = overlapBegin - begin + i;
+            for (size_t ch = 0; ch < m_config.numChannels; ++ch) {
+                m_mix[ch][out] += weight * m_scratch[ch][i];
+            }
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief Gets the reader of a source file, opening it on first use.
+ * @param filename The filename of the source
+ * @return The reader, or nullptr if the source cannot be used
+ */
+auto WavEdlReader::source(const std::string &filename) -> const WavReader * {
+    auto it = m_sources.find(filename);
+    if (it == m_sources.end()) {
+        auto reader = WavReader::create(filename);
+        if (reader) {
+            const auto config = reader->get_configuration();
+            if (config.sampleRate != m_config.sampleRate ||
+                config.numChannels != m_config.numChannels) {
+                reader.reset();
+            }
+        }
+        it = m_sources.emplace(filename, std::move(reader)).first;
+    }
+    return it->second ? &*it->second : nullptr;
+}
@@ -0,0 +1,87 @@
+/// WavGraph.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavGraph.h>
+
+/**
+ * @brief Public constructor that allocates the samples.
+ * @param numChannels The number of channels
+ * @param capacity The number of frames the block can hold
+ */
+WavBlock::WavBlock(const size_t numChannels, const size_t capacity) :
+    m_samples(numChannels * capacity), m_channels(numChannels),
+    m_capacity(capacity) {
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        m_channels[ch] = m_samples.data() + ch * capacity;
+    }
+}
+
+/**
+ * @brief Public constructor
+ * @param reader The reader, read from its current position
+ */
+WavReaderSource::WavReaderSource(WavReader reader) :
+    m_reader(std::move(reader)),
+    m_numChannels(m_reader.get_configuration().numChannels) {}
+
+/**
+ * @brief Reads the next block from the file.
+ * @param block The block to fill
+ * @return The number of frames read
+ */
+auto WavReaderSource::pull(WavBlock &block) -> size_t {
+    return m_reader.read_into(block.capacity(), block.channels());
+}
+
+/**
+ * @brief Gets the number of channels of the file.
+ * @return The number of channels
+ */
+auto WavReaderSource::num_channels() const -> size_t { return m_numChannels; }
+
+/**
+ * @brief Pulls every block out of a graph and writes it to a WAV file.
+ * @param node The last node of the graph
+ * @param writer The writer, with as many channels as the node
+ * @param blockFrames The number of frames per block
+ * @return The number of frames written
+ */
+auto run_graph(WavGraphNode &node, WavWriter &writer, const size_t blockFrames)
+        -> uint64_t {
+    if (writer.get_configuration().numChannels != node.num_channels()) {
+        return 0;
+    }
+    WavBlock block(node.num_channels(), std::max<size_t>(1, blockFrames));
+    uint64_t total = 0;
+    while (true) {
+        const size_t frames = node.pull(block);
+        if (frames == 0) {
+            break;
+        }
+        writer.write_buffer(block.channels(), frames);
+        total += frames;
+    }
+    return total;
+}
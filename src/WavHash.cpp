@@ -0,0 +1,244 @@
+/// WavHash.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavHash.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <AudioFileTools/WavConfiguration.h>
+#include <AudioFileTools/WavHeader.h>
+
+namespace {
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+/**
+ * @brief Reads a little-endian integer from unaligned memory.
+ */
+template<typename T>
+auto read_le(const uint8_t *data) -> T {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Mixes one 8-byte lane into an accumulator.
+ */
+auto mix_lane(uint64_t accumulator, const uint64_t lane) -> uint64_t {
+    accumulator += lane * kPrime2;
+    accumulator = std::rotl(accumulator, 31);
+    return accumulator * kPrime1;
+}
+
+/**
+ * @brief Folds an accumulator into the hash.
+ */
+auto merge_round(uint64_t hash, const uint64_t accumulator) -> uint64_t {
+    hash ^= mix_lane(0, accumulator);
+    return hash * kPrime1 + kPrime4;
+}
+} // namespace
+
+/**
+ * @brief Public constructor
+ * @param seed The seed of the hash
+ */
+WavHasher::WavHasher(const uint64_t seed) : m_seed(seed) { reset(); }
+
+/**
+ * @brief Restarts the hash.
+ */
+auto WavHasher::reset() -> void {
+    m_accumulators = {m_seed + kPrime1 + kPrime2, m_seed + kPrime2, m_seed,
+                      m_seed - kPrime1};
+    m_buffered = 0;
+    m_totalBytes = 0;
+}
+
+/**
+ * @brief Adds bytes to the hash.
+ * @param data The bytes
+ * @param byteCount The number of bytes
+ */
+auto WavHasher::update(const void *data, size_t byteCount) -> void {
+    auto bytes = static_cast<const uint8_t *>(data);
+    m_totalBytes += byteCount;
+    /// Complete a buffered stripe first
+    if (m_buffered > 0) {
+        const size_t fill = std::min(byteCount, m_buffer.size() - m_buffered);
+        std::memcpy(m_buffer.data() + m_buffered, bytes, fill);
+        m_buffered += fill;
+        bytes += fill;
+        byteCount -= fill;
+        if (m_buffered < m_buffer.size()) {
+            return;
+        }
+        for (size_t lane = 0; lane < 4; ++lane) {
+            m_accumulators[lane] = mix_lane(
+                    m_accumulators[lane],
+                    read_le<uint64_t>(m_buffer.data() + lane * 8));
+        }
+        m_buffered = 0;
+    }
+    while (byteCount >= 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            m_accumulators[lane] = mix_lane(m_accumulators[lane],
+                                         read_le<uint64_t>(bytes + lane * 8));
+        }
+        bytes += 32;
+        byteCount -= 32;
+    }
+    std::memcpy(m_buffer.data(), bytes, byteCount);
+    m_buffered = byteCount;
+}
+
+/**
+ * @brief Gets the hash of the bytes added so far.
+ * @return The digest
+ */
+auto WavHasher::digest() const -> uint64_t {
+    uint64_t hash;
+    if (m_totalBytes >= 32) {
+        hash = std::rotl(m_accumulators[0], 1) +
+               std::rotl(m_accumulators[1], 7) +
+               std::rotl(m_accumulators[2], 12) +
+               std::rotl(m_accumulators[3], 18);
+        for (const uint64_t accumulator : m_accumulators) {
+            hash = merge_round(hash, accumulator);
+        }
+    } else {
+        hash = m_seed + kPrime5;
+    }
+    hash += m_totalBytes;
+
+    const uint8_t *bytes = m_buffer.data();
+    size_t remaining = m_buffered;
+    while (remaining >= 8) {
+        hash ^= mix_lane(0, read_le<uint64_t>(bytes));
+        hash = std::rotl(hash, 27) * kPrime1 + kPrime4;
+        bytes += 8;
+        remaining -= 8;
+    }
+    if (remaining >= 4) {
+        hash ^= static_cast<uint64_t>(read_le<uint32_t>(bytes)) * kPrime1;
+        hash = std::rotl(hash, 23) * kPrime2 + kPrime3;
+        bytes += 4;
+        remaining -= 4;
+    }
+    while (remaining > 0) {
+        hash ^= *bytes * kPrime5;
+        hash = std::rotl(hash, 11) * kPrime1;
+        ++bytes;
+        --remaining;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/**
+ * @brief Reads the payload hash stored in a WAV file by WavWriter.
+ * @param filename The filename of the WAV file
+ * @return The stored digest, or std::nullopt if the file has none
+ */
+auto read_wav_stored_hash(const std::string &filename)
+        -> std::optional<uint64_t> {
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return std::nullopt;
+    }
+    WavFileConfiguration config;
+    const auto layout = read_wav_header(input, config);
+    if (!layout) {
+        return std::nullopt;
+    }
+    /// The hash chunk is written after the data chunk, so only walk the
+    /// chunks that follow it
+    input.seekg(static_cast<std::streamoff>(
+            layout->dataOffset + ((config.dataChunkSize + 1) & ~1ULL)));
+    while (input) {
+        std::array<char, 4> chunkId{};
+        uint32_t chunkSize = 0;
+        input.read(chunkId.data(), 4);
+        input.read(reinterpret_cast<char *>(&chunkSize), 4);
+        if (!input) {
+            break;
+        }
+        if (std::memcmp(chunkId.data(), kWavHashChunkId, 4) == 0 &&
+            chunkSize == 8) {
+            uint64_t digest = 0;
+            input.read(reinterpret_cast<char *>(&digest), 8);
+            if (!input) {
+                break;
+            }
+            return digest;
+        }
+        input.seekg((chunkSize + 1) & ~1u, std::ios::cur);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Hashes the data chunk payload of a WAV file.
+ * @param filename The filename of the WAV file
+ * @return The digest, or std::nullopt if the file is not a valid WAV file or
+ * its data chunk is truncated
+ */
+auto hash_wav_payload(const std::string &filename) -> std::optional<uint64_t> {
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return std::nullopt;
+    }
+    WavFileConfiguration config;
+    if (!read_wav_header(input, config)) {
+        return std::nullopt;
+    }
+    WavHasher hasher;
+    std::vector<char> buffer(1 << 20);
+    uint64_t remaining = config.dataChunkSize;
+    while (remaining > 0) {
+        const auto bytes = static_cast<std::streamsize>(
+                std::min<uint64_t>(remaining, buffer.size()));
+        input.read(buffer.data(), bytes);
+        if (input.gcount() != bytes) {
+            return std::nullopt;
+        }
+        hasher.update(buffer.data(), static_cast<size_t>(bytes));
+        remaining -= static_cast<uint64_t>(bytes);
+    }
+    return hasher.digest();
+}
@@ -0,0 +1,139 @@
+/// WavHeader.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavHeader.h>
+#include <AudioFileTools/WavTrace.h>
+
+#include <array>
+#include <cstring>
+
+/**
+ * @brief Reads a WAV file header from a stream and verifies that the
+ * configuration is supported.
+ * @param stream The stream to read, positioned at the start of the file
+ * @param config The configuration to fill in
+ * @return The header layout if the header is valid, std::nullopt otherwise
+ */
+auto read_wav_header(std::istream &stream, WavFileConfiguration &config)
+        -> std::optional<WavHeaderLayout> {
+    WavHeaderLayout layout;
+
+    // Read RIFF header
+    std::array<char, 4> chunkId{};
+    layout.riffSizeOffset = static_cast<uint64_t>(stream.tellg()) + 4;
+    stream.read(chunkId.data(), chunkId.size());
+    if (std::strncmp(chunkId.data(), "RIFF", 4) != 0) return std::nullopt;
+
+    uint32_t chunkSize;
+    stream.read(reinterpret_cast<char *>(&chunkSize), sizeof(chunkSize));
+
+    std::array<char, 4> format{};
+    stream.read(format.data(), format.size());
+    if (std::strncmp(format.data(), "WAVE", 4) != 0) return std::nullopt;
+
+    bool foundFmt = false;
+    bool foundData = false;
+
+    while (stream && (!foundFmt || !foundData)) {
+        std::array<char, 4> subchunkId{};
+        stream.read(subchunkId.data(), 4);
+        if (stream.gcount() != 4) break;
+
+        const auto subchunkSizeOffset = static_cast<uint64_t>(stream.tellg());
+        uint32_t subchunkSize = 0;
+        stream.read(reinterpret_cast<char *>(&subchunkSize), sizeof(subchunkSize));
+
+        if (std::strncmp(subchunkId.data(), "fmt ", 4) == 0) {
+            foundFmt = true;
+
+            uint16_t audioFormat, numChannels;
+            uint32_t sampleRate, byteRate;
+            uint16_t blockAlign, bitDepth;
+
+            stream.read(reinterpret_cast<char *>(&audioFormat), sizeof(audioFormat));
+            stream.read(reinterpret_cast<char *>(&numChannels), sizeof(numChannels));
+            stream.read(reinterpret_cast<char *>(&sampleRate), sizeof(sampleRate));
+            stream.read(reinterpret_cast<char *>(&byteRate), sizeof(byteRate));
+            stream.read(reinterpret_cast<char *>(&blockAlign), sizeof(blockAlign));
+            stream.read(reinterpret_cast<char *>(&bitDepth), sizeof(bitDepth));
+
+            // Skip any extra fmt bytes (and pad if odd size)
+            std::streamoff fmtExtraBytes = static_cast<std::streamoff>((subchunkSize + 1) & ~1u) - 16;
+            if (fmtExtraBytes > 0) {
+                stream.seekg(fmtExtraBytes, std::ios::cur);
+            }
+
+            // Assign to config
+            if (audioFormat == 1 || audioFormat == 3) {
+                config.format = static_cast<WavFormat>(audioFormat);
+            } else return std::nullopt;
+
+            if (numChannels > 0 && numChannels <= UINT8_MAX) {
+                config.numChannels = static_cast<uint8_t>(numChannels);
+            } else return std::nullopt;
+
+            if (bitDepth == 8 || bitDepth == 16 || bitDepth == 24 || bitDepth == 32) {
+                config.bitDepth = static_cast<WavBitDepth>(bitDepth);
+            } else return std::nullopt;
+
+            if (sampleRate == 8000 || sampleRate == 11025 || sampleRate == 16000 ||
+                sampleRate == 22050 || sampleRate == 32000 || sampleRate == 44100 ||
+                sampleRate == 48000 || sampleRate == 96000 || sampleRate == 176400 ||
+                sampleRate == 192000 || sampleRate == 352800 || sampleRate == 384000) {
+                config.sampleRate = static_cast<WavSampleRate>(sampleRate);
+            } else return std::nullopt;
+
+            config.blockAlign = blockAlign;
+
+            // Validate config
+            if (config.format == WavFormat::FLOAT && config.bitDepth != WavBitDepth::BIT_DEPTH_32) {
+                return std::nullopt;
+            }
+            if (blockAlign != numChannels * (bitDepth / 8)) return std::nullopt;
+
+        } else if (std::strncmp(subchunkId.data(), "data", 4) == 0) {
+            foundData = true;
+            config.dataChunkSize = subchunkSize;
+            layout.dataSizeOffset = subchunkSizeOffset;
+            layout.dataOffset = subchunkSizeOffset + 4;
+            // Skip the payload if the format chunk has not been seen yet
+            if (!foundFmt) {
+                stream.seekg((subchunkSize + 1) & ~1u, std::ios::cur);
+            }
+        } else {
+            // Skip unknown or unneeded chunk (and pad if odd size)
+            stream.seekg((subchunkSize + 1) & ~1u, std::ios::cur);
+        }
+
+        if (stream.fail()) return std::nullopt;
+    }
+
+    if (!foundFmt || !foundData) return std::nullopt;
+    stream.seekg(static_cast<std::streamoff>(layout.dataOffset), std::ios::beg);
+    if (stream.fail()) return std::nullopt;
+    WAV_TRACE5(header_parse, config.format, config.bitDepth, config.numChannels,
+               config.sampleRate, config.dataChunkSize);
+    return layout;
+}
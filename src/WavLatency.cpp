@@ -0,0 +1,158 @@
+/// WavLatency.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <AudioFileTools/WavLatency.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+/**
+ * @brief Public constructor
+ * @param deadlineNanoseconds The deadline, or 0 for none
+ */
+WavLatencyHistogram::WavLatencyHistogram(const uint64_t deadlineNanoseconds) :
+    m_deadline(deadlineNanoseconds) {}
+
+/**
+ * @brief Gets the bucket of a latency.
+ * @param nanoseconds The latency
+ * @return The index of the bucket
+ */
+auto WavLatencyHistogram::bucket_index(const uint64_t nanoseconds) -> size_t {
+    /// Below 2 * kSubBuckets every nanosecond has its own bucket, above it
+    /// each power of two is split into kSubBuckets
+    const auto width = static_cast<unsigned>(std::bit_width(nanoseconds));
+    if (width <= std::bit_width(2 * kSubBuckets - 1)) {
+        return nanoseconds;
+    }
+    const unsigned shift = width - std::bit_width(kSubBuckets);
+    const size_t index = 2 * kSubBuckets + (shift - 1) * kSubBuckets +
+                         ((nanoseconds >> shift) - kSubBuckets);
+    return std::min(index, kBuckets - 1);
+}
+
+/**
+ * @brief Gets the highest latency counted in a bucket.
+ * @param index The index of the bucket
+ * @return The latency in nanoseconds
+ */
+auto WavLatencyHistogram::bucket_upper(const size_t index) -> uint64_t {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    const size_t shift = (index - 2 * kSubBuckets) / kSubBuckets + 1;
+    const uint64_t sub = (index - 2 * kSubBuckets) % kSubBuckets + kSubBuckets;
+    return ((sub + 1) << shift) - 1;
+}
+
+/**
+ * @brief Records one latency.
+ * @param nanoseconds The latency
+ */
+auto WavLatencyHistogram::record(const uint64_t nanoseconds) -> void {
+    m_buckets[bucket_index(nanoseconds)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    if (m_deadline > 0 && nanoseconds > m_deadline) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanoseconds > max &&
+           !m_max.compare_exchange_weak(max, nanoseconds,
+                                        std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Gets the latency at a given percentile.
+ * @param percentile The percentile, between 0 and 100
+ * @return The highest latency in the bucket holding the percentile, or 0 if
+ * nothing was recorded
+ */
+auto WavLatencyHistogram::percentile(const double percentile) const
+        -> uint64_t {
+    const uint64_t count = m_count.load(std::memory_order_relaxed);
+    if (count == 0) {
+        return 0;
+    }
+    const auto rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(
+                       std::clamp(percentile, 0.0, 100.0) / 100.0 *
+                       static_cast<double>(count))));
+    const uint64_t max = m_max.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            /// The last bucket also holds every latency past its range
+            return i + 1 == kBuckets ? max : std::min(bucket_upper(i), max);
+        }
+    }
+    return max;
+}
+
+/**
+ * @brief Gets the count, deadline misses and main percentiles.
+ * @return The summary
+ */
+auto WavLatencyHistogram::summary() const -> WavLatencySummary {
+    return {.count = m_count.load(std::memory_order_relaxed),
+            .deadlineMisses = m_misses.load(std::memory_order_relaxed),
+            .p50 = percentile(50.0),
+            .p99 = percentile(99.0),
+            .p999 = percentile(99.9),
+            .max = m_max.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Gets the deadline.
+ * @return The deadline in nanoseconds, or 0 for none
+ */
+auto WavLatencyHistogram::deadline() const -> uint64_t { return m_deadline; }
+
+/**
+ * @brief Forgets every recorded latency.
+ */
+auto WavLatencyHistogram::reset() -> void {
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the duration of a block of frames at the sample rate of a
+ * configuration.
+ * @param config The configuration
+ * @param frames The number of frames per block
+ * @return The duration in nanoseconds
+ */
+auto wav_block_period(const WavFileConfiguration &config, const size_t frames)
+        -> uint64_t {
+    const auto sampleRate = static_cast<uint64_t>(config.sampleRate);
+    return static_cast<uint64_t>(frames) * 1'000'000'000ULL / sampleRate;
+}
@@ -0,0 +1,312 @@
+/// WavMixer.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavMixer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <optional>
+
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+/** Whether an explicit AVX2 and FMA kernel is built next to the scalar one */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define WAV_MIXER_AVX2_FMA 1
+#include <immintrin.h>
+#else
+#define WAV_MIXER_AVX2_FMA 0
+#endif
+
+namespace {
+/** A source channel added to an output channel with a gain */
+struct Route {
+    size_t sourceChannel;
+    size_t outputChannel;
+    float gain;
+};
+
+/** An opened source and its routes to the output */
+struct Source {
+    WavReader reader;
+    size_t numChannels;
+    size_t numFrames;
+    std::vector<Route> routes;
+};
+
+/** The buffers of one block being mixed */
+struct Block {
+    /** The first frame of the block */
+    size_t start = 0;
+    /** The number of frames in the block */
+    size_t frames = 0;
+    /** Whether every source was read completely */
+    bool complete = true;
+    /** The output bus, one vector per output channel */
+    std::vector<std::vector<float>> bus;
+    /** The samples of one source, one vector per source channel */
+    std::vector<std::vector<float>> scratch;
+    /** Pointers to the scratch vectors */
+    std::vector<float *> scratchArrays;
+};
+
+/**
+ * @brief Adds a scaled array to an accumulator.
+ * @details Written as a plain loop over unaliased arrays, so it is only
+ * vectorized when the compiler auto-vectorizes it, which GCC does from -O3.
+ * @param bus The accumulator
+ * @param samples The samples to add
+ * @param gain The gain applied to the samples
+ * @param count The number of samples
+ */
+auto accumulate_scalar(float *__restrict bus, const float *__restrict samples,
+                       const float gain, const size_t count) -> void {
+    for (size_t i = 0; i < count; ++i) {
+        bus[i] += gain * samples[i];
+    }
+}
+
+#if WAV_MIXER_AVX2_FMA
+/**
+ * @brief Adds a scaled array to an accumulator with 8-wide fused
+ * multiply-adds.
+ * @details Built for AVX2 and FMA whatever the compiler flags, so it is
+ * vectorized in every build type. Only called on CPUs that support both.
+ * @param bus The accumulator
+ * @param samples The samples to add
+ * @param gain The gain applied to the samples
+ * @param count The number of samples
+ */
+__attribute__((target("avx2,fma")))
+auto accumulate_avx2_fma(float *__restrict bus,
+                         const float *__restrict samples, const float gain,
+                         const size_t count) -> void {
+    const __m256 gains = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 sum = _mm256_fmadd_ps(gains, _mm256_loadu_ps(samples + i),
+                                           _mm256_loadu_ps(bus + i));
+        _mm256_storeu_ps(bus + i, sum);
+    }
+    for (; i < count; ++i) {
+        bus[i] = std::fma(gain, samples[i], bus[i]);
+    }
+}
+#endif
+
+/** The signature of the accumulate kernels */
+using AccumulateKernel = void (*)(float *__restrict, const float *__restrict,
+                                  float, size_t);
+
+/**
+ * @brief Adds a scaled array to an accumulator with the fastest kernel the
+ * CPU supports.
+ * @details The kernel is picked once, on first use, so the shipped library
+ * uses fused multiply-adds without being built for a specific CPU. Targets
+ * other than x86-64 always use the scalar loop.
+ * @param bus The accumulator
+ * @param samples The samples to add
+ * @param gain The gain applied to the samples
+ * @param count The number of samples
+ */
+auto accumulate(float *__restrict bus, const float *__restrict samples,
+                const float gain, const size_t count) -> void {
+    static const AccumulateKernel kernel = []() -> AccumulateKernel {
+#if WAV_MIXER_AVX2_FMA
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return accumulate_avx2_fma;
+        }
+#endif
+        return accumulate_scalar;
+    }();
+    kernel(bus, samples, gain, count);
+}
+
+/**
+ * @brief Works out how the channels of a source feed the output.
+ * @param source The mixer source
+ * @param numChannels The number of channels of the source
+ * @param outputChannels The number of channels of the output
+ * @return The routes, or std::nullopt if the layouts cannot be mixed
+ */
+auto make_routes(const WavMixerSource &source, const size_t numChannels,
+                 const size_t outputChannels)
+        -> std::optional<std::vector<Route>> {
+    const float pan = std::clamp(source.pan, -1.0f, 1.0f);
+    if (numChannels == 1 && outputChannels == 2) {
+        /// Constant-power pan law
+        const float angle = (pan + 1.0f) * std::numbers::pi_v<float> / 4.0f;
+        return std::vector<Route>{{0, 0, source.gain * std::cos(angle)},
+                                  {0, 1, source.gain * std::sin(angle)}};
+    }
+    if (numChannels == 2 && outputChannels == 2) {
+        /// Balance, which leaves a centred source untouched
+        return std::vector<Route>{
+                {0, 0, source.gain * std::min(1.0f, 1.0f - pan)},
+                {1, 1, source.gain * std::min(1.0f, 1.0f + pan)}};
+    }
+    if (numChannels == 2 && outputChannels == 1) {
+        return std::vector<Route>{{0, 0, source.gain * 0.5f},
+                                  {1, 0, source.gain * 0.5f}};
+    }
+    if (numChannels == outputChannels) {
+        std::vector<Route> routes;
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            routes.push_back({ch, ch, source.gain});
+        }
+        return routes;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Mixes the sources over the time range of a block.
+ * @param sources The sources
+ * @param block The block
+ */
+auto mix_block(const std::vector<Source> &sources, Block &block) -> void {
+    for (auto &channel : block.bus) {
+        std::fill_n(channel.begin(), block.frames, 0.0f);
+    }
+    for (const auto &source : sources) {
+        if (block.start >= source.numFrames) {
+            continue;
+        }
+        const size_t frames =
+                std::min(block.frames, source.numFrames - block.start);
+        const size_t framesRead = source.reader.read_at(
+                block.start, frames, block.scratchArrays.data());
+        if (framesRead < frames) {
+            block.complete = false;
+        }
+        for (const auto &route : source.routes) {
+            accumulate(block.bus[route.outputChannel].data(),
+                       block.scratch[route.sourceChannel].data(), route.gain,
+                       framesRead);
+        }
+    }
+}
+} // namespace
+
+/**
+ * @brief Public constructor that starts the worker threads.
+ * @param options The mixdown options
+ */
+WavMixer::WavMixer(const WavMixerOptions options) :
+    m_options(options), m_pool(options.numThreads) {}
+
+/**
+ * @brief Mixes the sources into a new WAV file.
+ * @param sources The sources
+ * @param output The configuration of the output file
+ * @return True if every source was mixed and the output written, false
+ * otherwise
+ */
+auto WavMixer::render(const std::vector<WavMixerSource> &sources,
+                      const WavFileConfiguration &output) -> bool {
+    std::vector<Source> opened;
+    size_t totalFrames = 0;
+    size_t maxChannels = 0;
+    for (const auto &source : sources) {
+        auto reader = WavReader::create(source.filename);
+        if (!reader) {
+            return false;
+        }
+        const auto config = reader->get_configuration();
+        auto routes =
+                make_routes(source, config.numChannels, output.numChannels);
+        if (config.sampleRate != output.sampleRate || !routes) {
+            return false;
+        }
+        opened.push_back({.reader = std::move(*reader),
+                          .numChannels = config.numChannels,
+                          .numFrames = config.num_samples(),
+                          .routes = std::move(*routes)});
+        totalFrames = std::max<size_t>(totalFrames, config.num_samples());
+        maxChannels = std::max<size_t>(maxChannels, config.numChannels);
+    }
+    auto writer = WavWriter::create(output);
+    if (!writer) {
+        return false;
+    }
+
+    /// Two blocks per worker, so workers mix one round while the previous
+    /// round is written
+    const size_t blockFrames = std::max<size_t>(1, m_options.blockFrames);
+    const size_t roundBlocks = m_pool.size();
+    std::vector<Block> blocks(2 * roundBlocks);
+    for (auto &block : blocks) {
+        block.bus.assign(output.numChannels,
+                         std::vector<float>(blockFrames));
+        block.scratch.assign(maxChannels, std::vector<float>(blockFrames));
+        for (auto &channel : block.scratch) {
+            block.scratchArrays.push_back(channel.data());
+        }
+    }
+    const auto submitRound = [&](const size_t round, const size_t first) {
+        for (size_t b = 0; b < roundBlocks; ++b) {
+            Block &block = blocks[first + b];
+            block.start = std::min(totalFrames,
+                                   (round * roundBlocks + b) * blockFrames);
+            block.frames = std::min(blockFrames, totalFrames - block.start);
+            block.complete = true;
+            if (block.frames > 0) {
+                m_pool.submit([&opened, &block] { mix_block(opened, block); });
+            }
+        }
+    };
+
+    const size_t numRounds =
+            (totalFrames + roundBlocks * blockFrames - 1) /
+            (roundBlocks * blockFrames);
+    bool complete = true;
+    std::vector<const float *> busArrays(output.numChannels);
+    if (numRounds > 0) {
+        submitRound(0, 0);
+    }
+    for (size_t round = 0; round < numRounds; ++round) {
+        m_pool.wait();
+        const size_t current = (round % 2) * roundBlocks;
+        if (round + 1 < numRounds) {
+            submitRound(round + 1, roundBlocks - current);
+        }
+        for (size_t b = 0; b < roundBlocks; ++b) {
+            Block &block = blocks[current + b];
+            if (block.frames == 0) {
+                continue;
+            }
+            complete = complete && block.complete;
+            for (size_t ch = 0; ch < output.numChannels; ++ch) {
+                busArrays[ch] = block.bus[ch].data();
+            }
+            writer->write_buffer(busArrays.data(), block.frames);
+        }
+    }
+    m_pool.wait();
+    writer->close_file();
+    return complete;
+}
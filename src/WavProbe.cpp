@@ -0,0 +1,524 @@
+/// WavProbe.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavProbe.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <streambuf>
+#include <thread>
+
+#include <AudioFileTools/WavHeader.h>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+/** Read-only stream buffer over a block of memory, so the header parser can
+ * run on the bytes read by io_uring */
+class MemoryStreamBuffer : public std::streambuf {
+public:
+    MemoryStreamBuffer(const uint8_t *data, const size_t size) {
+        auto *begin = const_cast<char *>(reinterpret_cast<const char *>(data));
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    auto seekoff(const off_type offset, const std::ios_base::seekdir direction,
+                 std::ios_base::openmode) -> pos_type override {
+        off_type base = 0;
+        if (direction == std::ios_base::cur) {
+            base = gptr() - eback();
+        } else if (direction == std::ios_base::end) {
+            base = egptr() - eback();
+        }
+        return seekpos(pos_type(base + offset), std::ios_base::in);
+    }
+
+    auto seekpos(const pos_type position, std::ios_base::openmode)
+            -> pos_type override {
+        const off_type offset = position;
+        if (offset < 0 || offset > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + offset, egptr());
+        return position;
+    }
+};
+
+/**
+ * @brief Parses a WAV header from the first bytes of a file.
+ * @param data The bytes read from the start of the file
+ * @param size The number of bytes read
+ * @param config The configuration to fill in
+ * @return True if the header was parsed, false otherwise
+ */
+auto parse_header(const uint8_t *data, const size_t size,
+                  WavFileConfiguration &config) -> bool {
+    MemoryStreamBuffer buffer(data, size);
+    std::istream stream(&buffer);
+    return read_wav_header(stream, config).has_value();
+}
+
+/**
+ * @brief Opens a file and parses its WAV header.
+ * @param filename The filename of the WAV file
+ * @return The configuration of the file, or std::nullopt on failure
+ */
+auto probe_file(const std::string &filename)
+        -> std::optional<WavFileConfiguration> {
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return std::nullopt;
+    }
+    WavFileConfiguration config;
+    config.filename = filename;
+    if (!read_wav_header(input, config)) {
+        return std::nullopt;
+    }
+    return config;
+}
+
+/**
+ * @brief Minimal io_uring instance driven through the raw system calls, so
+ * there is no dependency on liburing.
+ */
+class IoUring {
+public:
+    /**
+     * @brief Public constructor that sets up the rings.
+     * @param entries The number of submission queue entries
+     */
+    explicit IoUring(const unsigned entries) {
+        io_uring_params params{};
+        m_fd = static_cast<int>(
+                ::syscall(__NR_io_uring_setup, entries, &params));
+        if (m_fd < 0) {
+            return;
+        }
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes +
+                       params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+        m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sqRing == MAP_FAILED) {
+            m_sqRing = nullptr;
+            return;
+        }
+        m_cqRing = singleMmap ? m_sqRing
+                              : ::mmap(nullptr, m_cqRingSize,
+                                       PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, m_fd,
+                                       IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) {
+            m_cqRing = nullptr;
+            return;
+        }
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return;
+        }
+        m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+        auto *sq = static_cast<uint8_t *>(m_sqRing);
+        m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        m_sqEntries = params.sq_entries;
+        auto *cq = static_cast<uint8_t *>(m_cqRing);
+        m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        m_localTail = *m_sqTail;
+    }
+
+    /**
+     * @brief Public destructor that unmaps the rings.
+     */
+    ~IoUring() { reset(); }
+
+    /**
+     * @brief Unmaps the rings and closes the ring.
+     * @details The kernel finishes tearing the ring down asynchronously, so
+     * closing it neither cancels nor reaps the operations still in flight.
+     * Every submitted operation must have completed before this is called.
+     */
+    auto reset() -> void {
+        if (m_sqes != nullptr) ::munmap(m_sqes, m_sqesSize);
+        if (m_cqRing != nullptr && m_cqRing != m_sqRing)
+            ::munmap(m_cqRing, m_cqRingSize);
+        if (m_sqRing != nullptr) ::munmap(m_sqRing, m_sqRingSize);
+        if (m_fd >= 0) ::close(m_fd);
+        m_sqes = nullptr;
+        m_cqRing = nullptr;
+        m_sqRing = nullptr;
+        m_fd = -1;
+    }
+
+    /** Delete copy constructor and copy assignment operator */
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    /**
+     * @brief Checks that the rings were set up and the kernel supports a list
+     * of operations.
+     * @param operations The io_uring operation codes
+     * @return True if every operation is supported, false otherwise
+     */
+    [[nodiscard]] auto supports(std::initializer_list<uint8_t> operations) const
+            -> bool {
+        if (m_sqes == nullptr) {
+            return false;
+        }
+        /// io_uring_probe is followed by a flexible array of 256 operations
+        constexpr size_t maxOperations = 256;
+        std::vector<uint64_t> storage(
+                (sizeof(io_uring_probe) +
+                 maxOperations * sizeof(io_uring_probe_op)) /
+                sizeof(uint64_t));
+        auto *probe = reinterpret_cast<io_uring_probe *>(storage.data());
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE,
+                      probe, maxOperations) < 0) {
+            return false;
+        }
+        return std::ranges::all_of(operations, [probe](const uint8_t op) {
+            return op <= probe->last_op &&
+                   (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+        });
+    }
+
+    /**
+     * @brief Gets the next free submission queue entry.
+     * @return A zeroed entry, or nullptr if the submission queue is full
+     */
+    auto next_sqe() -> io_uring_sqe * {
+        const unsigned head =
+                std::atomic_ref(*m_sqHead).load(std::memory_order_acquire);
+        if (m_localTail - head >= m_sqEntries) {
+            return nullptr;
+        }
+        const unsigned index = m_localTail & m_sqMask;
+        io_uring_sqe *sqe = &m_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        m_sqArray[index] = index;
+        ++m_localTail;
+        ++m_unsubmitted;
+        return sqe;
+    }
+
+    /**
+     * @brief Submits the queued entries and waits for completions.
+     * @details If the kernel is temporarily short of resources (EAGAIN or
+     * EBUSY) the entries stay queued and this returns without waiting, so
+     * the caller can reap completions and try again.
+     * @param waitCount The number of completions to wait for
+     * @return True on success, false if the kernel rejected the submission
+     */
+    auto submit_and_wait(const unsigned waitCount) -> bool {
+        std::atomic_ref(*m_sqTail).store(m_localTail,
+                                         std::memory_order_release);
+        long result;
+        do {
+            result = ::syscall(__NR_io_uring_enter, m_fd, m_unsubmitted,
+                               waitCount, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } while (result < 0 && errno == EINTR);
+        if (result < 0) {
+            return errno == EAGAIN || errno == EBUSY;
+        }
+        m_unsubmitted -= static_cast<unsigned>(result);
+        return true;
+    }
+
+    /**
+     * @brief Waits for a completion without submitting anything.
+     * @details Falls back to polling the completion queue if the kernel
+     * refuses to wait, since completions are posted either way.
+     */
+    auto wait() -> void {
+        long result;
+        do {
+            result = ::syscall(__NR_io_uring_enter, m_fd, 0, 1,
+                               IORING_ENTER_GETEVENTS, nullptr, 0);
+        } while (result < 0 && errno == EINTR);
+        while (result < 0 &&
+               std::atomic_ref(*m_cqTail).load(std::memory_order_acquire) ==
+                       *m_cqHead) {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Takes back the entries that were queued but never accepted by
+     * the kernel.
+     * @param function Invoked with each discarded entry
+     * @return The number of discarded entries
+     */
+    template<typename Function>
+    auto discard_unsubmitted(Function &&function) -> unsigned {
+        const unsigned discarded = m_unsubmitted;
+        for (unsigned i = m_localTail - discarded; i != m_localTail; ++i) {
+            function(m_sqes[m_sqArray[i & m_sqMask]]);
+        }
+        m_localTail -= discarded;
+        m_unsubmitted = 0;
+        std::atomic_ref(*m_sqTail).store(m_localTail,
+                                         std::memory_order_release);
+        return discarded;
+    }
+
+    /**
+     * @brief Hands every available completion to a function.
+     * @param function Invoked with the user data and result of each
+     * completion
+     */
+    template<typename Function>
+    auto for_each_completion(Function &&function) -> void {
+        unsigned head = *m_cqHead;
+        const unsigned tail =
+                std::atomic_ref(*m_cqTail).load(std::memory_order_acquire);
+        while (head != tail) {
+            const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            function(cqe.user_data, cqe.res);
+            ++head;
+        }
+        std::atomic_ref(*m_cqHead).store(head, std::memory_order_release);
+    }
+
+private:
+    int m_fd = -1;
+    void *m_sqRing = nullptr;
+    void *m_cqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    size_t m_sqesSize = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    unsigned *m_sqHead = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned *m_sqArray = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+    unsigned m_localTail = 0;
+    unsigned m_unsubmitted = 0;
+};
+
+/** The stage of a file in the io_uring pipeline, kept in the user data */
+enum class ProbeStage : uint64_t {
+    OPEN = 0,
+    READ = 1,
+    CLOSE = 2,
+};
+
+/**
+ * @brief Probes files through io_uring, keeping one open, read or close in
+ * flight per slot.
+ * @param ring The io_uring instance
+ * @param filenames The filenames of the WAV files
+ * @param callback The callback receiving the result for each file
+ * @param options The probing options
+ */
+auto probe_with_ring(IoUring &ring, const std::vector<std::string> &filenames,
+                     const WavProbeCallback &callback,
+                     const WavProbeOptions &options) -> void {
+    struct Slot {
+        size_t index = 0;
+        int fd = -1;
+        std::vector<uint8_t> buffer;
+    };
+    const size_t numSlots =
+            std::clamp<size_t>(options.queueDepth, 1, filenames.size());
+    std::vector<Slot> slots(numSlots);
+    for (auto &slot : slots) {
+        slot.buffer.resize(options.headerBytes);
+    }
+    std::vector<bool> reported(filenames.size(), false);
+    const auto report = [&](const size_t index,
+                            const std::optional<WavFileConfiguration> &config) {
+        reported[index] = true;
+        callback(index, config);
+    };
+    const auto userData = [](const size_t slot, const ProbeStage stage) {
+        return static_cast<uint64_t>(slot) << 2 | static_cast<uint64_t>(stage);
+    };
+
+    /// Each slot holds at most one entry, so the queue never overflows
+    size_t nextFile = 0;
+    size_t inFlight = 0;
+    const auto startNext = [&](const size_t slot) {
+        if (nextFile >= filenames.size()) {
+            return;
+        }
+        slots[slot].index = nextFile++;
+        io_uring_sqe *sqe = ring.next_sqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(
+                filenames[slots[slot].index].c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = userData(slot, ProbeStage::OPEN);
+        ++inFlight;
+    };
+    for (size_t slot = 0; slot < numSlots; ++slot) {
+        startNext(slot);
+    }
+
+    /// Once the kernel rejects a submission, nothing new is queued and the
+    /// operations already submitted are drained before the ring and the slot
+    /// buffers go away, closing every file they opened
+    bool failed = false;
+    while (inFlight > 0) {
+        if (!failed && !ring.submit_and_wait(1)) {
+            failed = true;
+            inFlight -= ring.discard_unsubmitted([](const io_uring_sqe &sqe) {
+                if (sqe.opcode == IORING_OP_CLOSE) {
+                    ::close(sqe.fd);
+                }
+            });
+        }
+        if (failed) {
+            if (inFlight == 0) {
+                break;
+            }
+            ring.wait();
+        }
+        ring.for_each_completion([&](const uint64_t data, const int32_t result) {
+            const size_t slotIndex = data >> 2;
+            Slot &slot = slots[slotIndex];
+            --inFlight;
+            if (failed) {
+                if (static_cast<ProbeStage>(data & 3) == ProbeStage::OPEN &&
+                    result >= 0) {
+                    ::close(result);
+                }
+                return;
+            }
+            switch (static_cast<ProbeStage>(data & 3)) {
+                case ProbeStage::OPEN: {
+                    if (result < 0) {
+                        report(slot.index, std::nullopt);
+                        startNext(slotIndex);
+                        break;
+                    }
+                    slot.fd = result;
+                    io_uring_sqe *sqe = ring.next_sqe();
+                    sqe->opcode = IORING_OP_READ;
+                    sqe->fd = slot.fd;
+                    sqe->addr = reinterpret_cast<uint64_t>(slot.buffer.data());
+                    sqe->len = static_cast<uint32_t>(slot.buffer.size());
+                    sqe->off = 0;
+                    sqe->user_data = userData(slotIndex, ProbeStage::READ);
+                    ++inFlight;
+                    break;
+                }
+                case ProbeStage::READ: {
+                    WavFileConfiguration config;
+                    config.filename = filenames[slot.index];
+                    const auto bytesRead = static_cast<size_t>(std::max(result, 0));
+                    if (parse_header(slot.buffer.data(), bytesRead, config)) {
+                        report(slot.index, config);
+                    } else if (bytesRead == slot.buffer.size()) {
+                        /// The header may continue past the bytes read
+                        report(slot.index, probe_file(filenames[slot.index]));
+                    } else {
+                        report(slot.index, std::nullopt);
+                    }
+                    /// The descriptor belongs to the close from here on
+                    io_uring_sqe *sqe = ring.next_sqe();
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->fd = slot.fd;
+                    sqe->user_data = userData(slotIndex, ProbeStage::CLOSE);
+                    slot.fd = -1;
+                    ++inFlight;
+                    break;
+                }
+                case ProbeStage::CLOSE: {
+                    startNext(slotIndex);
+                    break;
+                }
+            }
+        });
+    }
+
+    /// Reads that were discarded or drained still own their descriptors
+    for (auto &slot : slots) {
+        if (slot.fd >= 0) {
+            ::close(slot.fd);
+            slot.fd = -1;
+        }
+    }
+
+    /// If the kernel stopped accepting submissions, finish synchronously
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (!reported[i]) {
+            callback(i, probe_file(filenames[i]));
+        }
+    }
+}
+} // namespace
+
+/**
+ * @brief Reads and parses the headers of many WAV files.
+ * @param filenames The filenames of the WAV files
+ * @param callback The callback receiving the result for each file
+ * @param options The probing options
+ * @return True if io_uring was used, false if the synchronous fallback was
+ * used
+ */
+auto probe_wav_headers(const std::vector<std::string> &filenames,
+                       const WavProbeCallback &callback,
+                       const WavProbeOptions &options) -> bool {
+    if (options.useIoUring && !filenames.empty() && options.headerBytes > 0) {
+        const auto entries = static_cast<unsigned>(
+                std::clamp<size_t>(options.queueDepth, 1, filenames.size()));
+        IoUring ring(entries);
+        if (ring.supports({IORING_OP_OPENAT, IORING_OP_READ,
+                           IORING_OP_CLOSE})) {
+            probe_with_ring(ring, filenames, callback, options);
+            return true;
+        }
+    }
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        callback(i, probe_file(filenames[i]));
+    }
+    return false;
+}
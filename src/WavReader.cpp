@@ -24,16 +24,32 @@ SOFTWARE.
 
 #include <AudioFileTools/WavReader.h>
 
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+/** The alignment of offsets, sizes and buffers for O_DIRECT reads */
+constexpr uint64_t kDirectIoAlignment = 4096;
+} // namespace
+
 /**
  * @brief Public constructor that verifies the configuration and creates a
  * WAV file reader object.
  * @param filename The filename of the WAV file
+ * @param options The page cache hints and I/O mode
  * @return A WAV reader object if the configuration is valid, std::nullopt
  * otherwise
  */
-auto WavReader::create(const std::string &filename)
+auto WavReader::create(const std::string &filename,
+                       const WavReaderOptions options)
         -> std::optional<WavReader> {
-    auto obj = WavReader(filename);
+    auto obj = WavReader(filename, options);
     if (!obj.open_file()) {
         return std::nullopt;
     }
@@ -44,7 +60,7 @@ auto WavReader::create(const std::string &filename)
  * @brief Public destructor
  */
 WavReader::~WavReader() {
-    if (m_fileStream.is_open()) {
+    if (m_fileDescriptor >= 0) {
         close_file();
     }
 }
@@ -53,10 +69,12 @@ WavReader::~WavReader() {
  * @brief Close the WAV file.
  */
 auto WavReader::close_file() -> void {
-    if (!m_fileStream.is_open()) {
+    if (m_fileDescriptor < 0) {
         return;
     }
-    m_fileStream.close();
+    ::close(m_fileDescriptor);
+    m_fileDescriptor = -1;
+    WAV_TRACE1(reader_close, this);
 }
 
 /**
@@ -66,16 +84,85 @@ auto WavReader::close_file() -> void {
 auto WavReader::get_configuration() -> WavFileConfiguration { return m_config; }
 
 /**
- * @brief Reads raw samples from the WAV file.
+ * @brief Moves the position used by read() and read_into().
+ * @param frame The index of the next frame to read
+ * @return True if the frame is within the data chunk, false otherwise
+ */
+auto WavReader::seek_frame(const size_t frame) -> bool {
+    if (frame > m_config.num_samples()) {
+        return false;
+    }
+    m_cursor = frame;
+    if (m_stats) {
+        m_stats->add_seeks();
+    }
+    if (frame == 0) {
+        m_hasher.reset();
+        m_hashedFrames = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the position used by read() and read_into().
+ * @return The index of the next frame to read
+ */
+auto WavReader::tell_frame() const -> size_t { return m_cursor; }
+
+/**
+ * @brief Asks the kernel to start reading a range of frames into the page
+ * cache, without waiting for it.
+ * @param frame The index of the first frame
+ * @param count The number of frames
+ */
+auto WavReader::prefetch(const size_t frame, const size_t count) const
+        -> void {
+    const size_t totalFrames = m_config.num_samples();
+    if (m_fileDescriptor < 0 || frame >= totalFrames) {
+        return;
+    }
+    const size_t frames = std::min(count, totalFrames - frame);
+    ::posix_fadvise(m_fileDescriptor,
+                    static_cast<off_t>(m_headerLayout.dataOffset +
+                                       frame * m_config.blockAlign),
+                    static_cast<off_t>(frames * m_config.blockAlign),
+                    POSIX_FADV_WILLNEED);
+}
+
+/**
+ * @brief Reads raw bytes from a given offset in the WAV file.
+ * @param offset The offset in the file to read from
+ * @param buffer The buffer to read into
  * @param byteCount The number of bytes to read
- * @return The raw samples
- */
-auto WavReader::read_raw_samples(const size_t byteCount)
-        -> std::vector<uint8_t> {
-    std::vector<uint8_t> buffer(byteCount);
-    m_fileStream.read(reinterpret_cast<char *>(buffer.data()),
-                      static_cast<std::streamsize>(byteCount));
-    return buffer;
+ * @param directBuffer The aligned buffer for O_DIRECT reads, grown if needed
+ * @return The number of bytes read, which is less than byteCount at the end
+ * of the file or on error
+ */
+auto WavReader::read_raw_at(const uint64_t offset, uint8_t *buffer,
+                            const size_t byteCount,
+                            AlignedBuffer &directBuffer) const -> size_t {
+    if (m_directIo) {
+        return read_direct_at(offset, buffer, byteCount, directBuffer);
+    }
+    WAV_REALTIME_BLOCKING("pread");
+    size_t bytesRead = 0;
+    while (bytesRead < byteCount) {
+        const ssize_t result =
+                ::pread(m_fileDescriptor, buffer + bytesRead,
+                        byteCount - bytesRead,
+                        static_cast<off_t>(offset + bytesRead));
+        if (m_stats) {
+            m_stats->add_io_call();
+        }
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        bytesRead += static_cast<size_t>(result);
+    }
+    return bytesRead;
 }
 
 /**
@@ -83,100 +170,183 @@ auto WavReader::read_raw_samples(const size_t byteCount)
  * @return True if the file was opened successfully, false otherwise
  */
 auto WavReader::open_file() -> bool {
-    m_fileStream.open(m_config.filename, std::ios::binary | std::ios::in);
-    if (!m_fileStream) {
+    std::ifstream input(m_config.filename, std::ios::binary | std::ios::in);
+    if (!input) {
         return false;
     }
-    return read_header();
+    const auto layout = read_wav_header(input, m_config);
+    if (!layout) {
+        return false;
+    }
+    m_headerLayout = *layout;
+    if (m_options.directIo) {
+        m_fileDescriptor =
+                ::open(m_config.filename.c_str(), O_RDONLY | O_DIRECT);
+        m_directIo = m_fileDescriptor >= 0;
+    }
+    if (m_fileDescriptor < 0) {
+        m_fileDescriptor = ::open(m_config.filename.c_str(), O_RDONLY);
+    }
+    if (m_fileDescriptor < 0) {
+        return false;
+    }
+    WAV_TRACE3(reader_open, m_config.filename.c_str(), m_fileDescriptor,
+               m_directIo);
+    if (m_options.sequential) {
+        ::posix_fadvise(m_fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    return true;
 }
 
 /**
- * @brief Reads the WAV file header and verifies that the configuration is
- * valid.
- */
-auto WavReader::read_header() -> bool {
-    // Read RIFF header
-    std::array<char, 4> chunkId{};
-    m_fileStream.read(chunkId.data(), chunkId.size());
-    if (std::strncmp(chunkId.data(), "RIFF", 4) != 0) return false;
-
-    uint32_t chunkSize;
-    m_fileStream.read(reinterpret_cast<char *>(&chunkSize), sizeof(chunkSize));
-
-    std::array<char, 4> format{};
-    m_fileStream.read(format.data(), format.size());
-    if (std::strncmp(format.data(), "WAVE", 4) != 0) return false;
-
-    bool foundFmt = false;
-    bool foundData = false;
-
-    while (m_fileStream && (!foundFmt || !foundData)) {
-        std::array<char, 4> subchunkId{};
-        m_fileStream.read(subchunkId.data(), 4);
-        if (m_fileStream.gcount() != 4) break;
-
-        uint32_t subchunkSize = 0;
-        m_fileStream.read(reinterpret_cast<char *>(&subchunkSize), sizeof(subchunkSize));
-
-        if (std::strncmp(subchunkId.data(), "fmt ", 4) == 0) {
-            foundFmt = true;
-
-            uint16_t audioFormat, numChannels;
-            uint32_t sampleRate, byteRate;
-            uint16_t blockAlign, bitDepth;
-
-            m_fileStream.read(reinterpret_cast<char *>(&audioFormat), sizeof(audioFormat));
-            m_fileStream.read(reinterpret_cast<char *>(&numChannels), sizeof(numChannels));
-            m_fileStream.read(reinterpret_cast<char *>(&sampleRate), sizeof(sampleRate));
-            m_fileStream.read(reinterpret_cast<char *>(&byteRate), sizeof(byteRate));
-            m_fileStream.read(reinterpret_cast<char *>(&blockAlign), sizeof(blockAlign));
-            m_fileStream.read(reinterpret_cast<char *>(&bitDepth), sizeof(bitDepth));
-
-            // Skip any extra fmt bytes
-            std::streamoff fmtExtraBytes = static_cast<std::streamoff>(subchunkSize) - 16;
-            if (fmtExtraBytes > 0) {
-                m_fileStream.seekg(fmtExtraBytes, std::ios::cur);
-            }
-
-            // Assign to config
-            if (audioFormat == 1 || audioFormat == 3) {
-                m_config.format = static_cast<WavFormat>(audioFormat);
-            } else return false;
-
-            if (numChannels > 0) {
-                m_config.numChannels = numChannels;
-            } else return false;
-
-            if (bitDepth == 8 || bitDepth == 16 || bitDepth == 24 || bitDepth == 32) {
-                m_config.bitDepth = static_cast<WavBitDepth>(bitDepth);
-            } else return false;
-
-            if (sampleRate == 8000 || sampleRate == 11025 || sampleRate == 16000 ||
-                sampleRate == 22050 || sampleRate == 32000 || sampleRate == 44100 ||
-                sampleRate == 48000 || sampleRate == 96000 || sampleRate == 176400 ||
-                sampleRate == 192000 || sampleRate == 352800 || sampleRate == 384000) {
-                m_config.sampleRate = static_cast<WavSampleRate>(sampleRate);
-            } else return false;
-
-            m_config.blockAlign = blockAlign;
-
-            // Validate config
-            if (m_config.format == WavFormat::FLOAT && m_config.bitDepth != WavBitDepth::BIT_DEPTH_32) {
-                return false;
-            }
-
-        } else if (std::strncmp(subchunkId.data(), "data", 4) == 0) {
-            foundData = true;
-            m_config.dataChunkSize = subchunkSize;
-        } else {
-            // Skip unknown or unneeded chunk (and pad if odd size)
-            m_fileStream.seekg((subchunkSize + 1) & ~1, std::ios::cur);
+ * @brief Reads raw bytes through an aligned buffer, for O_DIRECT.
+ * @param offset The offset in the file to read from
+ * @param buffer The buffer to read into
+ * @param byteCount The number of bytes to read
+ * @param directBuffer The aligned buffer to read through, grown if needed
+ * @return The number of bytes read
+ */
+auto WavReader::read_direct_at(const uint64_t offset, uint8_t *buffer,
+                               const size_t byteCount,
+                               AlignedBuffer &directBuffer) const -> size_t {
+    /// Widen the range to whole aligned blocks
+    const uint64_t start = offset & ~(kDirectIoAlignment - 1);
+    const uint64_t end = (offset + byteCount + kDirectIoAlignment - 1) &
+                         ~(kDirectIoAlignment - 1);
+    const auto length = static_cast<size_t>(end - start);
+    /// The buffer only grows, so once it holds the largest block read,
+    /// reading does not allocate. It is sized for the widest range a read of
+    /// byteCount can span at any offset, so it does not grow again when a
+    /// later block crosses one more sector boundary.
+    if (directBuffer.size < length) {
+        const size_t size = ((byteCount + kDirectIoAlignment - 1) &
+                             ~(kDirectIoAlignment - 1)) +
+                            kDirectIoAlignment;
+        WAV_REALTIME_ALLOCATION("std::aligned_alloc");
+        directBuffer.data.reset(static_cast<uint8_t *>(
+                std::aligned_alloc(kDirectIoAlignment, size)));
+        directBuffer.size = directBuffer.data ? size : 0;
+        if (!directBuffer.data) {
+            return 0;
+        }
+        if (m_stats) {
+            m_stats->add_allocations();
+        }
+    }
+    uint8_t *const aligned = directBuffer.data.get();
+    WAV_REALTIME_BLOCKING("pread");
+    size_t bytesRead = 0;
+    while (bytesRead < length) {
+        const ssize_t result =
+                ::pread(m_fileDescriptor, aligned + bytesRead,
+                        length - bytesRead,
+                        static_cast<off_t>(start + bytesRead));
+        if (m_stats) {
+            m_stats->add_io_call();
         }
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        bytesRead += static_cast<size_t>(result);
+        /// A short read means the end of the file
+        if (bytesRead % kDirectIoAlignment != 0) {
+            break;
+        }
+    }
+    const size_t skipped = offset - start;
+    if (bytesRead <= skipped) {
+        return 0;
+    }
+    const size_t copied = std::min(byteCount, bytesRead - skipped);
+    std::memcpy(buffer, aligned + skipped, copied);
+    return copied;
+}
 
-        if (m_fileStream.fail()) return false;
+/**
+ * @brief Applies the read-ahead and drop-behind hints after read() moved the
+ * cursor.
+ */
+auto WavReader::advise_consumed() -> void {
+    /// Pages read with O_DIRECT never enter the page cache
+    if (m_directIo) {
+        return;
+    }
+    const uint64_t position =
+            m_headerLayout.dataOffset + m_cursor * m_config.blockAlign;
+    if (m_options.readAheadBytes > 0) {
+        WAV_REALTIME_BLOCKING("posix_fadvise");
+        ::posix_fadvise(m_fileDescriptor, static_cast<off_t>(position),
+                        static_cast<off_t>(m_options.readAheadBytes),
+                        POSIX_FADV_WILLNEED);
     }
+    if (m_options.dropBehind && position > m_droppedUntil) {
+        WAV_REALTIME_BLOCKING("posix_fadvise");
+        ::posix_fadvise(m_fileDescriptor, static_cast<off_t>(m_droppedUntil),
+                        static_cast<off_t>(position - m_droppedUntil),
+                        POSIX_FADV_DONTNEED);
+        /// The kernel only drops whole pages, so resume from the start of
+        /// the partly read one next time
+        m_droppedUntil = position & ~(kDirectIoAlignment - 1);
+    }
+}
+
+/**
+ * @brief Checks whether reads bypass the page cache.
+ * @return True if the file was opened with O_DIRECT, false otherwise
+ */
+auto WavReader::is_direct_io() const -> bool { return m_directIo; }
 
-    return foundFmt && foundData;
+/**
+ * @brief Gets the hash of the data chunk payload, computed as read() goes
+ * through the file.
+ * @return The XXH64 digest of the payload, or std::nullopt if read() has not
+ * read the whole payload in order
+ */
+auto WavReader::get_payload_hash() const -> std::optional<uint64_t> {
+    if (m_hashedFrames * m_config.blockAlign != m_config.dataChunkSize) {
+        return std::nullopt;
+    }
+    return m_hasher.digest();
+}
+
+/**
+ * @brief Gets the statistics collected since the reader was opened or the
+ * statistics were reset.
+ * @return The statistics, all zero when they are not collected
+ */
+auto WavReader::get_stats() const -> WavIoStats {
+    return m_stats ? m_stats->snapshot() : WavIoStats{};
+}
+
+/**
+ * @brief Sets the statistics back to zero.
+ */
+auto WavReader::reset_stats() -> void {
+    if (m_stats) {
+        m_stats->reset();
+    }
+}
+
+/**
+ * @brief Gets the latencies of read_into() calls recorded since the reader
+ * was opened or the latencies were reset.
+ * @return The count, deadline misses and percentiles, all zero when
+ * latencies are not recorded
+ */
+auto WavReader::get_latency() const -> WavLatencySummary {
+    return m_latency ? m_latency->summary() : WavLatencySummary{};
+}
+
+/**
+ * @brief Forgets the recorded latencies.
+ */
+auto WavReader::reset_latency() -> void {
+    if (m_latency) {
+        m_latency->reset();
+    }
 }
 
 auto WavReader::num_samples() const -> uint32_t {
@@ -0,0 +1,126 @@
+/// WavReaderGroup.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavReaderGroup.h>
+
+/**
+ * @brief Public constructor that opens the WAV files.
+ * @param filenames The filenames of the WAV files
+ * @param options The group options
+ * @return A reader group object if every file was opened and the formats
+ * match, std::nullopt otherwise
+ */
+auto WavReaderGroup::create(const std::vector<std::string> &filenames,
+                            const WavReaderGroupOptions options)
+        -> std::optional<WavReaderGroup> {
+    if (filenames.empty()) {
+        return std::nullopt;
+    }
+    auto obj = WavReaderGroup(options);
+    obj.m_channelOffsets.push_back(0);
+    for (const auto &filename : filenames) {
+        auto reader = WavReader::create(filename);
+        if (!reader) {
+            return std::nullopt;
+        }
+        const auto config = reader->get_configuration();
+        if (!obj.m_readers.empty()) {
+            const auto first = obj.m_readers.front().get_configuration();
+            if (config.sampleRate != first.sampleRate ||
+                config.bitDepth != first.bitDepth ||
+                config.format != first.format) {
+                return std::nullopt;
+            }
+        }
+        obj.m_channelOffsets.push_back(obj.m_channelOffsets.back() +
+                                       config.numChannels);
+        obj.m_numFrames =
+                std::max<size_t>(obj.m_numFrames, config.num_samples());
+        obj.m_readers.push_back(std::move(*reader));
+    }
+    obj.m_pool = std::make_unique<WavThreadPool>(options.numThreads);
+    if (options.readAheadFrames > 0) {
+        for (const auto &reader : obj.m_readers) {
+            reader.prefetch(0, options.readAheadFrames);
+        }
+    }
+    return obj;
+}
+
+/**
+ * @brief Gets the configuration of one file of the group.
+ * @param index The index of the file
+ * @return The configuration of the file
+ */
+auto WavReaderGroup::get_configuration(const size_t index)
+        -> WavFileConfiguration {
+    return m_readers[index].get_configuration();
+}
+
+/**
+ * @brief Gets the number of files in the group.
+ * @return The number of files
+ */
+auto WavReaderGroup::size() const -> size_t { return m_readers.size(); }
+
+/**
+ * @brief Gets the total number of channels across all files.
+ * @return The number of channels
+ */
+auto WavReaderGroup::num_channels() const -> size_t {
+    return m_channelOffsets.back();
+}
+
+/**
+ * @brief Gets the length of the longest file.
+ * @return The number of frames
+ */
+auto WavReaderGroup::num_frames() const -> size_t { return m_numFrames; }
+
+/**
+ * @brief Moves the position of every file.
+ * @param frame The index of the next frame to read
+ * @return True if the frame is within the longest file, false otherwise
+ */
+auto WavReaderGroup::seek_frame(const size_t frame) -> bool {
+    if (frame > m_numFrames) {
+        return false;
+    }
+    m_cursor = frame;
+    for (auto &reader : m_readers) {
+        reader.seek_frame(std::min<size_t>(
+                frame, reader.get_configuration().num_samples()));
+        if (m_options.readAheadFrames > 0) {
+            reader.prefetch(reader.tell_frame(), m_options.readAheadFrames);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the shared position.
+ * @return The index of the next frame to read
+ */
+auto WavReaderGroup::tell_frame() const -> size_t { return m_cursor; }
@@ -0,0 +1,218 @@
+/// WavRealtime.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <AudioFileTools/WavRealtime.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+/** The depth of nested real-time scopes on this thread */
+thread_local unsigned t_depth = 0;
+
+/** The violations counted on this thread */
+thread_local WavRealtimeViolations t_violations;
+
+/** Whether violations abort the process */
+std::atomic<bool> g_abort{false};
+} // namespace
+
+/**
+ * @brief Public constructor
+ */
+WavRealtimeScope::WavRealtimeScope() { ++t_depth; }
+
+/**
+ * @brief Public destructor
+ */
+WavRealtimeScope::~WavRealtimeScope() { --t_depth; }
+
+/**
+ * @brief Checks whether the calling thread is in a real-time scope.
+ * @return True if it is, false otherwise
+ */
+auto wav_in_realtime_scope() -> bool { return t_depth > 0; }
+
+/**
+ * @brief Counts a violation if the calling thread is in a real-time scope.
+ * @param kind The kind of violation
+ * @param call The name of the call, a string literal
+ */
+auto wav_realtime_report(const WavRealtimeViolationKind kind,
+                         const char *call) -> void {
+    if (t_depth == 0) {
+        return;
+    }
+    switch (kind) {
+        case WavRealtimeViolationKind::ALLOCATION:
+            ++t_violations.allocations;
+            break;
+        case WavRealtimeViolationKind::DEALLOCATION:
+            ++t_violations.deallocations;
+            break;
+        case WavRealtimeViolationKind::BLOCKING_CALL:
+            ++t_violations.blockingCalls;
+            break;
+    }
+    t_violations.lastCall = call;
+    if (g_abort.load(std::memory_order_relaxed)) {
+        std::abort();
+    }
+}
+
+/**
+ * @brief Gets the violations counted on the calling thread.
+ * @return The violations
+ */
+auto wav_realtime_violations() -> WavRealtimeViolations {
+    return t_violations;
+}
+
+/**
+ * @brief Sets the violations counted on the calling thread back to zero.
+ */
+auto wav_realtime_reset_violations() -> void { t_violations = {}; }
+
+/**
+ * @brief Makes every violation abort the process.
+ * @param abort Whether to abort
+ */
+auto wav_realtime_abort_on_violation(const bool abort) -> void {
+    g_abort.store(abort, std::memory_order_relaxed);
+}
+
+#if AUDIO_FILE_TOOLS_RT_CHECKS
+/// Replacements of the global allocation functions, so that every
+/// allocation made through new, including those of the standard containers,
+/// is checked. They forward to malloc and free, which keeps them compatible
+/// with the sanitizers that intercept those.
+namespace {
+/**
+ * @brief Allocates memory after checking the real-time scope.
+ */
+auto checked_alloc(std::size_t size, const std::size_t alignment) -> void * {
+    wav_realtime_report(WavRealtimeViolationKind::ALLOCATION, "operator new");
+    size = size == 0 ? 1 : size;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment,
+                              (size + alignment - 1) & ~(alignment - 1));
+}
+
+/**
+ * @brief Frees memory after checking the real-time scope.
+ */
+auto checked_free(void *pointer) -> void {
+    if (pointer != nullptr) {
+        wav_realtime_report(WavRealtimeViolationKind::DEALLOCATION,
+                            "operator delete");
+    }
+    std::free(pointer);
+}
+
+/**
+ * @brief Allocates memory or throws std::bad_alloc.
+ */
+auto checked_alloc_or_throw(const std::size_t size,
+                            const std::size_t alignment) -> void * {
+    if (void *pointer = checked_alloc(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+auto operator new(const std::size_t size) -> void * {
+    return checked_alloc_or_throw(size, 0);
+}
+auto operator new[](const std::size_t size) -> void * {
+    return checked_alloc_or_throw(size, 0);
+}
+auto operator new(const std::size_t size, const std::align_val_t alignment)
+        -> void * {
+    return checked_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+auto operator new[](const std::size_t size, const std::align_val_t alignment)
+        -> void * {
+    return checked_alloc_or_throw(size, static_cast<std::size_t>(alignment));
+}
+auto operator new(const std::size_t size, const std::nothrow_t &) noexcept
+        -> void * {
+    return checked_alloc(size, 0);
+}
+auto operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+        -> void * {
+    return checked_alloc(size, 0);
+}
+auto operator new(const std::size_t size, const std::align_val_t alignment,
+                  const std::nothrow_t &) noexcept -> void * {
+    return checked_alloc(size, static_cast<std::size_t>(alignment));
+}
+auto operator new[](const std::size_t size, const std::align_val_t alignment,
+                    const std::nothrow_t &) noexcept -> void * {
+    return checked_alloc(size, static_cast<std::size_t>(alignment));
+}
+auto operator delete(void *pointer) noexcept -> void { checked_free(pointer); }
+auto operator delete[](void *pointer) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete(void *pointer, std::size_t) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete[](void *pointer, std::size_t) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete(void *pointer, std::align_val_t) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete[](void *pointer, std::align_val_t) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+        -> void {
+    checked_free(pointer);
+}
+auto operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+        -> void {
+    checked_free(pointer);
+}
+auto operator delete(void *pointer, const std::nothrow_t &) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete[](void *pointer, const std::nothrow_t &) noexcept
+        -> void {
+    checked_free(pointer);
+}
+auto operator delete(void *pointer, std::align_val_t,
+                     const std::nothrow_t &) noexcept -> void {
+    checked_free(pointer);
+}
+auto operator delete[](void *pointer, std::align_val_t,
+                       const std::nothrow_t &) noexcept -> void {
+    checked_free(pointer);
+}
+#endif
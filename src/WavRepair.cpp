@@ -0,0 +1,184 @@
+/// WavRepair.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavRepair.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <thread>
+
+#include <AudioFileTools/WavHeader.h>
+
+namespace {
+/**
+ * @brief Checks whether a data chunk size agrees with the rest of the file.
+ * @param file The WAV file
+ * @param dataOffset The offset of the first byte of audio data
+ * @param riffChunkSize The RIFF chunk size stored in the header
+ * @param dataChunkSize The data chunk size stored in the header
+ * @param fileSize The size of the file
+ * @return True if the data chunk ends the file or is followed by a chunk
+ * header with a printable ID and a size that fits in the file
+ */
+auto data_chunk_size_is_consistent(std::fstream &file,
+                                   const uint64_t dataOffset,
+                                   const uint32_t riffChunkSize,
+                                   const uint32_t dataChunkSize,
+                                   const uint64_t fileSize) -> bool {
+    /// A writer that crashed before finalizing leaves both sizes at zero, so
+    /// any bytes after the header are audio and must never be probed as a
+    /// chunk header
+    if (riffChunkSize == 0 || dataChunkSize == 0) {
+        return fileSize == dataOffset;
+    }
+    const uint64_t dataEnd = dataOffset + dataChunkSize;
+    const uint64_t chunkOffset = dataEnd + (dataChunkSize & 1u);
+    if (dataEnd > fileSize) {
+        return false;
+    }
+    if (dataEnd == fileSize || chunkOffset == fileSize) {
+        return true;
+    }
+    if (chunkOffset + 8 > fileSize) {
+        return false;
+    }
+    std::array<char, 4> id{};
+    uint32_t chunkSize = 0;
+    file.seekg(static_cast<std::streamoff>(chunkOffset), std::ios::beg);
+    file.read(id.data(), 4);
+    file.read(reinterpret_cast<char *>(&chunkSize), 4);
+    if (!file) {
+        file.clear();
+        return false;
+    }
+    const bool printable = std::ranges::all_of(id, [](const char c) {
+        return c >= 0x20 && c <= 0x7e;
+    });
+    return printable && chunkOffset + 8 + chunkSize <= fileSize;
+}
+} // namespace
+
+/**
+ * @brief Repairs the RIFF and data chunk sizes of a WAV file whose writer did
+ * not finalize the header.
+ * @param filename The filename of the WAV file
+ * @return The repaired configuration if the file is a valid WAV file,
+ * std::nullopt otherwise
+ */
+auto repair_wav_header(const std::string &filename)
+        -> std::optional<WavFileConfiguration> {
+    std::fstream file(filename,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) {
+        return std::nullopt;
+    }
+    WavFileConfiguration config;
+    config.filename = filename;
+    const auto layout = read_wav_header(file, config);
+    if (!layout || config.blockAlign == 0) {
+        return std::nullopt;
+    }
+    file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < layout->dataOffset) {
+        return std::nullopt;
+    }
+    uint32_t riffChunkSize = 0;
+    file.seekg(static_cast<std::streamoff>(layout->riffSizeOffset),
+               std::ios::beg);
+    file.read(reinterpret_cast<char *>(&riffChunkSize), 4);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    /// The stored size is only trusted if it ends the file or is followed by
+    /// another valid chunk. A stale size left by a crashed writer that was
+    /// reopened with open_append() leaves audio after the data chunk instead.
+    if (data_chunk_size_is_consistent(file, layout->dataOffset, riffChunkSize,
+                                      config.dataChunkSize, fileSize)) {
+        return config;
+    }
+
+    /// Derive the data size from the file length, rounded down to whole
+    /// frames and clamped to what the 32-bit RIFF size can describe
+    const uint64_t maxDataSize = UINT32_MAX - (layout->dataOffset - 8);
+    uint64_t dataSize = std::min(fileSize - layout->dataOffset, maxDataSize);
+    dataSize -= dataSize % config.blockAlign;
+    const auto dataChunkSize = static_cast<uint32_t>(dataSize);
+    const auto chunkSize =
+            static_cast<uint32_t>(layout->dataOffset - 8 + dataChunkSize);
+
+    file.clear();
+    file.seekp(static_cast<std::streamoff>(layout->riffSizeOffset),
+               std::ios::beg);
+    file.write(reinterpret_cast<const char *>(&chunkSize), 4);
+    file.seekp(static_cast<std::streamoff>(layout->dataSizeOffset),
+               std::ios::beg);
+    file.write(reinterpret_cast<const char *>(&dataChunkSize), 4);
+    file.flush();
+    if (!file) {
+        return std::nullopt;
+    }
+    config.dataChunkSize = dataChunkSize;
+    return config;
+}
+
+/**
+ * @brief Repairs the headers of many WAV files concurrently.
+ * @param filenames The filenames of the WAV files
+ * @param numThreads The number of worker threads, or 0 to use one per
+ * hardware thread
+ * @return The result of repair_wav_header() for each file, in the same order
+ * as the filenames
+ */
+auto repair_wav_headers(const std::vector<std::string> &filenames,
+                        size_t numThreads)
+        -> std::vector<std::optional<WavFileConfiguration>> {
+    std::vector<std::optional<WavFileConfiguration>> results(filenames.size());
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, filenames.size());
+
+    /// Each worker claims the next unrepaired file until none are left
+    std::atomic<size_t> next = 0;
+    const auto worker = [&] {
+        for (size_t i = next++; i < filenames.size(); i = next++) {
+            results[i] = repair_wav_header(filenames[i]);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return results;
+}
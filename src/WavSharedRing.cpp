@@ -0,0 +1,222 @@
+/// WavSharedRing.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavSharedRing.h>
+
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+/** Identifies a shared memory object as a WAV ring ("WAVR") */
+constexpr uint32_t kRingMagic = 0x52564157;
+
+/** The offset of the ring buffer, past the header */
+constexpr size_t kDataOffset =
+        (sizeof(WavSharedRingHeader) + 63) / 64 * 64;
+} // namespace
+
+/**
+ * @brief Public constructor that creates the shared memory ring.
+ * @param name The name of the shared memory object, starting with '/'
+ * @param configuration The format of the frames in the ring
+ * @param capacityFrames The number of frames the ring can hold
+ * @return A producer object if the ring was created, std::nullopt otherwise
+ */
+auto WavRingProducer::create(const std::string &name,
+                             const WavFileConfiguration &configuration,
+                             const size_t capacityFrames)
+        -> std::optional<WavRingProducer> {
+    if (capacityFrames == 0 || configuration.numChannels == 0) {
+        return std::nullopt;
+    }
+    if (configuration.format == WavFormat::FLOAT &&
+        configuration.bitDepth != WavBitDepth::BIT_DEPTH_32) {
+        return std::nullopt;
+    }
+    auto obj = WavRingProducer(name, configuration);
+    obj.m_config.blockAlign = static_cast<uint16_t>(
+            obj.m_config.numChannels *
+            (static_cast<uint16_t>(obj.m_config.bitDepth) / 8));
+    obj.m_capacity = capacityFrames;
+    obj.m_mappingLength =
+            kDataOffset + capacityFrames * obj.m_config.blockAlign;
+
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(obj.m_mappingLength)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+    void *mapping = ::mmap(nullptr, obj.m_mappingLength,
+                           PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+
+    /// Publish the magic last, so a consumer never sees a partial header
+    auto *header = new (mapping) WavSharedRingHeader{};
+    header->sampleRate = static_cast<uint32_t>(obj.m_config.sampleRate);
+    header->numChannels = obj.m_config.numChannels;
+    header->bitDepth = static_cast<uint16_t>(obj.m_config.bitDepth);
+    header->format = static_cast<uint16_t>(obj.m_config.format);
+    header->blockAlign = obj.m_config.blockAlign;
+    header->capacityFrames = capacityFrames;
+    std::atomic_ref(header->magic).store(kRingMagic,
+                                         std::memory_order_release);
+    obj.m_header = header;
+    obj.m_data = static_cast<uint8_t *>(mapping) + kDataOffset;
+    return obj;
+}
+
+/**
+ * @brief Public destructor
+ */
+WavRingProducer::~WavRingProducer() {
+    if (m_header == nullptr) {
+        return;
+    }
+    finish();
+    ::munmap(m_header, m_mappingLength);
+    ::shm_unlink(m_name.c_str());
+}
+
+/**
+ * @brief Marks the stream as finished, so the consumer stops once it has
+ * drained the ring.
+ */
+auto WavRingProducer::finish() -> void {
+    m_header->finished.store(1, std::memory_order_release);
+}
+
+/**
+ * @brief Public constructor that opens an existing shared memory ring.
+ * @param name The name of the shared memory object, starting with '/'
+ * @return A consumer object if the ring was opened, std::nullopt otherwise
+ */
+auto WavRingConsumer::open(const std::string &name)
+        -> std::optional<WavRingConsumer> {
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < kDataOffset) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto length = static_cast<size_t>(info.st_size);
+    void *mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    auto *header = static_cast<WavSharedRingHeader *>(mapping);
+    if (std::atomic_ref(header->magic).load(std::memory_order_acquire) !=
+                kRingMagic ||
+        header->blockAlign == 0 ||
+        kDataOffset + header->capacityFrames * header->blockAlign > length) {
+        ::munmap(mapping, length);
+        return std::nullopt;
+    }
+    auto obj = WavRingConsumer();
+    obj.m_config.sampleRate = static_cast<WavSampleRate>(header->sampleRate);
+    obj.m_config.numChannels = static_cast<uint8_t>(header->numChannels);
+    obj.m_config.bitDepth = static_cast<WavBitDepth>(header->bitDepth);
+    obj.m_config.format = static_cast<WavFormat>(header->format);
+    obj.m_config.blockAlign = header->blockAlign;
+    obj.m_header = header;
+    obj.m_data = static_cast<const uint8_t *>(mapping) + kDataOffset;
+    obj.m_mappingLength = length;
+    obj.m_capacity = header->capacityFrames;
+    return obj;
+}
+
+/**
+ * @brief Public destructor
+ */
+WavRingConsumer::~WavRingConsumer() {
+    if (m_header != nullptr) {
+        ::munmap(m_header, m_mappingLength);
+    }
+}
+
+/**
+ * @brief Gets the format of the frames in the ring.
+ * @return The configuration, with an empty filename
+ */
+auto WavRingConsumer::get_configuration() -> WavFileConfiguration {
+    return m_config;
+}
+
+/**
+ * @brief Writes every frame currently in the ring to a WAV writer.
+ * @param writer The writer
+ * @return The number of frames written
+ */
+auto WavRingConsumer::drain_to(WavWriter &writer) -> size_t {
+    const uint64_t readFrame =
+            m_header->readFrame.load(std::memory_order_relaxed);
+    const uint64_t writeFrame =
+            m_header->writeFrame.load(std::memory_order_acquire);
+    const size_t frames = writeFrame - readFrame;
+    if (frames == 0) {
+        return 0;
+    }
+    /// Write in up to two segments when the data wraps around
+    const size_t start = readFrame % m_capacity;
+    const size_t first = std::min(frames, m_capacity - start);
+    writer.write_encoded(m_data + start * m_config.blockAlign,
+                         first * m_config.blockAlign);
+    if (first < frames) {
+        writer.write_encoded(m_data, (frames - first) * m_config.blockAlign);
+    }
+    m_header->readFrame.store(writeFrame, std::memory_order_release);
+    return frames;
+}
+
+/**
+ * @brief Checks whether the producer has finished and the ring is empty.
+ * @return True if no more frames will arrive, false otherwise
+ */
+auto WavRingConsumer::is_finished() const -> bool {
+    /// Load the flag first, so frames written before it was set are seen
+    if (m_header->finished.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    return m_header->writeFrame.load(std::memory_order_acquire) ==
+           m_header->readFrame.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,165 @@
+/// WavThreadPool.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavThreadPool.h>
+
+#include <algorithm>
+
+namespace {
+/** The pool that owns the current thread, if it is a worker */
+thread_local const WavThreadPool *t_pool = nullptr;
+
+/** The index of the current thread in its pool */
+thread_local size_t t_index = 0;
+} // namespace
+
+/**
+ * @brief Public constructor that starts the worker threads.
+ * @param numThreads The number of worker threads, or 0 to use one per
+ * hardware thread
+ */
+WavThreadPool::WavThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+    m_threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_threads.emplace_back(&WavThreadPool::run_worker, this, i);
+    }
+}
+
+/**
+ * @brief Public destructor that runs the remaining tasks and joins the worker
+ * threads.
+ */
+WavThreadPool::~WavThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Queues a task to run on one of the worker threads.
+ * @param task The task
+ */
+auto WavThreadPool::submit(std::function<void()> task) -> void {
+    const size_t index = t_pool == this
+                                 ? t_index
+                                 : m_nextQueue++ % m_queues.size();
+    ++m_pending;
+    {
+        std::lock_guard lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_queued;
+    }
+    m_taskAvailable.notify_one();
+}
+
+/**
+ * @brief Blocks until every submitted task has finished.
+ */
+auto WavThreadPool::wait() -> void {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_pending == 0; });
+}
+
+/**
+ * @brief Gets the number of worker threads.
+ * @return The number of worker threads
+ */
+auto WavThreadPool::size() const -> size_t { return m_threads.size(); }
+
+/**
+ * @brief Runs tasks on a worker thread until the pool is stopped.
+ * @param index The index of the worker
+ */
+auto WavThreadPool::run_worker(const size_t index) -> void {
+    t_pool = this;
+    t_index = index;
+    std::function<void()> task;
+    while (true) {
+        if (take_task(index, task)) {
+            task();
+            task = nullptr;
+            if (--m_pending == 0) {
+                std::lock_guard lock(m_mutex);
+                m_idle.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock lock(m_mutex);
+        m_taskAvailable.wait(lock,
+                             [this] { return m_stopping || m_queued > 0; });
+        if (m_stopping && m_queued <= 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Takes a task from a worker's own queue, or steals one from another
+ * worker.
+ * @param index The index of the worker
+ * @param task The task taken
+ * @return True if a task was taken, false if every queue is empty
+ */
+auto WavThreadPool::take_task(const size_t index, std::function<void()> &task)
+        -> bool {
+    /// Newest task from the worker's own queue, which is still warm in cache
+    {
+        auto &queue = *m_queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --m_queued;
+            return true;
+        }
+    }
+    /// Oldest task from the other queues
+    for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+        auto &queue = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            --m_queued;
+            return true;
+        }
+    }
+    return false;
+}
@@ -170,4 +170,44 @@ auto convert_uint8_to_int32(const uint8_t sample) -> int32_t {
  */
 auto convert_int16_to_int32(const int16_t sample) -> int32_t {
     return static_cast<int32_t>(sample) << 16;
+}
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to a float sample.
+ * @param sample The int24 sample
+ * @return The float sample
+ */
+auto convert_int24_to_float(const int32_t sample) -> float {
+    return static_cast<float>(sample) / 8388607.0f;
+}
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an uint8_t sample.
+ * @param sample The int24 sample
+ * @return The uint8_t sample
+ */
+auto convert_int24_to_uint8(const int32_t sample) -> uint8_t {
+    return static_cast<uint8_t>(((sample >> 16) + 128) & 0xFF);
+}
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an int16_t sample.
+ * @param sample The int24 sample
+ * @return The int16_t sample
+ */
+auto convert_int24_to_int16(const int32_t sample) -> int16_t {
+    return static_cast<int16_t>(sample >> 8);
+}
+
+/**
+ * @brief Helper function to convert an int24 sample, which is stored in an
+ * int32_t, to an int32_t sample.
+ * @param sample The int24 sample
+ * @return The int32_t sample
+ */
+auto convert_int24_to_int32(const int32_t sample) -> int32_t {
+    return static_cast<int32_t>(static_cast<uint32_t>(sample) << 8);
 }
\ No newline at end of file
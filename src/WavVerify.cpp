@@ -0,0 +1,367 @@
+/// WavVerify.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavVerify.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <AudioFileTools/WavHash.h>
+#include <AudioFileTools/WavHeader.h>
+#include <AudioFileTools/WavThreadPool.h>
+
+namespace {
+/**
+ * @brief Reads bytes at a given offset.
+ * @return True if every byte was read, false otherwise
+ */
+auto read_exact_at(const int fd, void *buffer, const size_t byteCount,
+                   const uint64_t offset) -> bool {
+    size_t bytesRead = 0;
+    while (bytesRead < byteCount) {
+        const ssize_t result =
+                ::pread(fd, static_cast<char *>(buffer) + bytesRead,
+                        byteCount - bytesRead,
+                        static_cast<off_t>(offset + bytesRead));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        bytesRead += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether there is a plausible chunk ID at an offset.
+ */
+auto has_chunk_id_at(const int fd, const uint64_t offset,
+                     const uint64_t fileSize) -> bool {
+    std::array<char, 4> chunkId{};
+    if (offset + 8 > fileSize ||
+        !read_exact_at(fd, chunkId.data(), 4, offset)) {
+        return false;
+    }
+    for (const char c : chunkId) {
+        if (!std::isprint(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Walks the chunks of a WAV file and records structural issues.
+ * @param fd The file descriptor
+ * @param report The report to fill in
+ */
+auto walk_chunks(const int fd, WavVerifyReport &report) -> void {
+    std::array<char, 12> riff{};
+    if (!read_exact_at(fd, riff.data(), riff.size(), 0) ||
+        std::memcmp(riff.data(), "RIFF", 4) != 0 ||
+        std::memcmp(riff.data() + 8, "WAVE", 4) != 0) {
+        report.issues.push_back(WavVerifyIssue::NOT_WAVE);
+        return;
+    }
+    uint32_t riffSize = 0;
+    std::memcpy(&riffSize, riff.data() + 4, 4);
+    const bool riffSizeMatches = riffSize + 8ULL == report.fileSize;
+    if (!riffSizeMatches) {
+        report.issues.push_back(WavVerifyIssue::RIFF_SIZE_MISMATCH);
+    }
+
+    bool foundFmt = false;
+    bool foundData = false;
+    uint64_t offset = 12;
+    while (offset + 8 <= report.fileSize) {
+        std::array<char, 4> chunkId{};
+        uint32_t chunkSize = 0;
+        if (!read_exact_at(fd, chunkId.data(), 4, offset) ||
+            !read_exact_at(fd, &chunkSize, 4, offset + 4)) {
+            break;
+        }
+        const bool isData = std::memcmp(chunkId.data(), "data", 4) == 0;
+        foundFmt = foundFmt || std::memcmp(chunkId.data(), "fmt ", 4) == 0;
+        foundData = foundData || isData;
+        const uint64_t end = offset + 8 + chunkSize;
+        if (end > report.fileSize) {
+            report.issues.push_back(isData ? WavVerifyIssue::TRUNCATED_DATA
+                                           : WavVerifyIssue::CHUNK_OVERRUN);
+            break;
+        }
+        uint64_t next = end;
+        if (chunkSize % 2 != 0) {
+            /// The pad byte is missing if the next chunk starts where the pad
+            /// should be. A final chunk may end at EOF without its pad, as
+            /// WavWriter writes it, as long as the RIFF size agrees
+            if (end == report.fileSize
+                        ? !riffSizeMatches
+                        : !has_chunk_id_at(fd, end + 1, report.fileSize) &&
+                                  has_chunk_id_at(fd, end, report.fileSize)) {
+                report.issues.push_back(WavVerifyIssue::MISSING_PADDING);
+            } else {
+                next = end + 1;
+            }
+        }
+        offset = next;
+    }
+    if (!foundFmt) {
+        report.issues.push_back(WavVerifyIssue::MISSING_FORMAT);
+    }
+    if (!foundData) {
+        report.issues.push_back(WavVerifyIssue::MISSING_DATA);
+    }
+}
+} // namespace
+
+/**
+ * @brief Gets the name of an issue, as used in reports.
+ * @param issue The issue
+ * @return The name of the issue
+ */
+auto to_string(const WavVerifyIssue issue) -> const char * {
+    switch (issue) {
+        case WavVerifyIssue::OPEN_FAILED:
+            return "open_failed";
+        case WavVerifyIssue::NOT_WAVE:
+            return "not_wave";
+        case WavVerifyIssue::RIFF_SIZE_MISMATCH:
+            return "riff_size_mismatch";
+        case WavVerifyIssue::CHUNK_OVERRUN:
+            return "chunk_overrun";
+        case WavVerifyIssue::MISSING_PADDING:
+            return "missing_padding";
+        case WavVerifyIssue::MISSING_FORMAT:
+            return "missing_format";
+        case WavVerifyIssue::UNSUPPORTED_FORMAT:
+            return "unsupported_format";
+        case WavVerifyIssue::MISSING_DATA:
+            return "missing_data";
+        case WavVerifyIssue::TRUNCATED_DATA:
+            return "truncated_data";
+        case WavVerifyIssue::PARTIAL_FRAME:
+            return "partial_frame";
+        case WavVerifyIssue::HASH_MISMATCH:
+            return "hash_mismatch";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Verifies the structure of a WAV file.
+ * @param filename The filename of the WAV file
+ * @param options The verification options
+ * @return The report for the file
+ */
+auto verify_wav_file(const std::string &filename,
+                     const WavVerifyOptions &options) -> WavVerifyReport {
+    WavVerifyReport report;
+    report.filename = filename;
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    struct stat info {};
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        report.issues.push_back(WavVerifyIssue::OPEN_FAILED);
+        return report;
+    }
+    report.fileSize = static_cast<uint64_t>(info.st_size);
+    walk_chunks(fd, report);
+    ::close(fd);
+    const auto found = [&report](const WavVerifyIssue issue) {
+        return std::ranges::find(report.issues, issue) != report.issues.end();
+    };
+    if (found(WavVerifyIssue::NOT_WAVE) ||
+        found(WavVerifyIssue::MISSING_FORMAT) ||
+        found(WavVerifyIssue::MISSING_DATA)) {
+        return report;
+    }
+
+    /// The format checks of the header parser decide what is supported
+    std::ifstream input(filename, std::ios::binary | std::ios::in);
+    WavFileConfiguration config;
+    config.filename = filename;
+    if (!read_wav_header(input, config)) {
+        report.issues.push_back(WavVerifyIssue::UNSUPPORTED_FORMAT);
+        return report;
+    }
+    if (config.dataChunkSize % config.blockAlign != 0) {
+        report.issues.push_back(WavVerifyIssue::PARTIAL_FRAME);
+    }
+    report.config = config;
+
+    if (options.checkHash) {
+        if (const auto stored = read_wav_stored_hash(filename)) {
+            report.hashChecked = true;
+            if (hash_wav_payload(filename) != stored) {
+                report.issues.push_back(WavVerifyIssue::HASH_MISMATCH);
+            }
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Verifies many WAV files concurrently on a thread pool.
+ * @param filenames The filenames of the WAV files
+ * @param options The verification options
+ * @return The report for each file, in the same order as the filenames
+ */
+auto verify_wav_files(const std::vector<std::string> &filenames,
+                      const WavVerifyOptions &options)
+        -> std::vector<WavVerifyReport> {
+    std::vector<WavVerifyReport> reports(filenames.size());
+    WavThreadPool pool(options.numThreads);
+    /// One long-running task per worker, each claiming the next file
+    std::atomic<size_t> next = 0;
+    const auto worker = [&] {
+        for (size_t i = next++; i < filenames.size(); i = next++) {
+            reports[i] = verify_wav_file(filenames[i], options);
+        }
+    };
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pool.submit(worker);
+    }
+    pool.wait();
+    return reports;
+}
+
+/**
+ * @brief Verifies a list of WAV files read one filename per line,
+ * concurrently on a thread pool.
+ * @param filenames The stream of filenames, one per line
+ * @param callback The callback receiving the report for each file
+ * @param options The verification options
+ * @return The number of files verified
+ */
+auto verify_wav_files(std::istream &filenames,
+                      const WavVerifyCallback &callback,
+                      const WavVerifyOptions &options) -> size_t {
+    std::mutex listMutex;
+    std::mutex callbackMutex;
+    size_t count = 0;
+    WavThreadPool pool(options.numThreads);
+    /// One long-running task per worker, each taking the next filename
+    const auto worker = [&] {
+        std::string filename;
+        while (true) {
+            size_t index = 0;
+            {
+                const std::lock_guard lock(listMutex);
+                do {
+                    if (!std::getline(filenames, filename)) {
+                        return;
+                    }
+                } while (filename.empty());
+                index = count++;
+            }
+            const WavVerifyReport report = verify_wav_file(filename, options);
+            const std::lock_guard lock(callbackMutex);
+            callback(index, report);
+        }
+    };
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pool.submit(worker);
+    }
+    pool.wait();
+    return count;
+}
+
+/**
+ * @brief Writes verification reports as a JSON array.
+ * @param stream The stream to write to
+ * @param reports The reports
+ */
+auto write_wav_verify_json(std::ostream &stream,
+                           const std::vector<WavVerifyReport> &reports)
+        -> void {
+    stream << "[\n";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        stream << "  ";
+        write_wav_verify_json(stream, reports[i]);
+        stream << (i + 1 < reports.size() ? "," : "") << "\n";
+    }
+    stream << "]\n";
+}
+
+/**
+ * @brief Writes one verification report as a JSON object.
+ * @param stream The stream to write to
+ * @param report The report
+ */
+auto write_wav_verify_json(std::ostream &stream,
+                           const WavVerifyReport &report) -> void {
+    const auto writeString = [&stream](const std::string &text) {
+        stream << '"';
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                stream << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                stream << "\\u" << std::hex << std::setw(4)
+                       << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                stream << c;
+            }
+        }
+        stream << '"';
+    };
+    stream << "{\"file\": ";
+    writeString(report.filename);
+    stream << ", \"valid\": " << (report.valid() ? "true" : "false")
+           << ", \"size\": " << report.fileSize;
+    if (report.config) {
+        stream << ", \"channels\": "
+               << static_cast<int>(report.config->numChannels)
+               << ", \"sample_rate\": "
+               << static_cast<int>(report.config->sampleRate)
+               << ", \"bit_depth\": "
+               << static_cast<int>(report.config->bitDepth)
+               << ", \"format\": "
+               << (report.config->format == WavFormat::FLOAT ? "\"float\""
+                                                             : "\"pcm\"")
+               << ", \"frames\": " << report.config->num_samples();
+    }
+    stream << ", \"hash_checked\": "
+           << (report.hashChecked ? "true" : "false") << ", \"issues\": [";
+    for (size_t j = 0; j < report.issues.size(); ++j) {
+        stream << (j > 0 ? ", " : "") << '"' << to_string(report.issues[j])
+               << '"';
+    }
+    stream << "]}";
+}
@@ -24,27 +24,84 @@ SOFTWARE.
 
 #include <AudioFileTools/WavWriter.h>
 
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+/** The alignment of offsets, sizes and buffers for O_DIRECT writes */
+constexpr size_t kDirectIoAlignment = 4096;
+
+/**
+ * @brief Writes a whole buffer at a given offset.
+ * @param fd The file descriptor
+ * @param data The bytes to write
+ * @param byteCount The number of bytes to write
+ * @param offset The offset in the file
+ * @return True if every byte was written, false otherwise
+ */
+auto write_all_at(const int fd, const uint8_t *data, const size_t byteCount,
+                  const uint64_t offset) -> bool {
+    size_t written = 0;
+    while (written < byteCount) {
+        const ssize_t result =
+                ::pwrite(fd, data + written, byteCount - written,
+                         static_cast<off_t>(offset + written));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+} // namespace
+
 /**
  * @brief Public constructor that verifies the configuration and creates a
  * WAV file writer object.
  * @param configuration WAV writer configuration
+ * @param options The I/O mode
  * @return A WAV writer object if the configuration is valid, std::nullopt
  * otherwise
  */
-auto WavWriter::create(WavFileConfiguration configuration)
+auto WavWriter::create(WavFileConfiguration configuration,
+                       const WavWriterOptions options)
         -> std::optional<WavWriter> {
-    auto obj = WavWriter(std::move(configuration));
+    auto obj = WavWriter(std::move(configuration), options);
     if (!obj.open_file()) {
         return std::nullopt;
     }
     return obj;
 }
 
+/**
+ * @brief Public constructor that reopens an existing WAV file and continues
+ * writing at the end of its data chunk.
+ * @param configuration WAV writer configuration, where the filename is the
+ * path of the existing file
+ * @return A WAV writer object if the existing file matches the configuration,
+ * std::nullopt otherwise
+ */
+auto WavWriter::open_append(WavFileConfiguration configuration)
+        -> std::optional<WavWriter> {
+    auto obj = WavWriter(std::move(configuration));
+    if (!obj.open_existing_file()) {
+        return std::nullopt;
+    }
+    return obj;
+}
+
 /**
  * @brief Public destructor
  */
 WavWriter::~WavWriter() {
-    if (m_fileStream.is_open()) {
+    if (m_fileStream.is_open() || m_directFileDescriptor >= 0) {
         close_file();
     }
 }
@@ -53,11 +110,90 @@ WavWriter::~WavWriter() {
  * @brief Close the WAV file.
  */
 auto WavWriter::close_file() -> void {
+    if (m_directFileDescriptor >= 0) {
+        finalize_direct();
+        WAV_TRACE1(writer_close, this);
+        return;
+    }
     if (!m_fileStream.is_open()) {
         return;
     }
+    const std::string trailing = trailing_chunks();
+    m_fileStream.write(trailing.data(),
+                       static_cast<std::streamsize>(trailing.size()));
     finalize_header();
     m_fileStream.close();
+    if (m_fileStream.fail()) {
+        m_writeFailed = true;
+    }
+    WAV_TRACE1(writer_close, this);
+}
+
+/**
+ * @brief Gets the hash of the samples written so far.
+ * @return The XXH64 digest of the encoded samples
+ */
+auto WavWriter::get_payload_hash() const -> uint64_t {
+    return m_hasher.digest();
+}
+
+/**
+ * @brief Gets the statistics collected since the writer was opened or the
+ * statistics were reset.
+ * @return The statistics, all zero when they are not collected
+ */
+auto WavWriter::get_stats() const -> WavIoStats {
+    return m_stats ? m_stats->snapshot() : WavIoStats{};
+}
+
+/**
+ * @brief Sets the statistics back to zero.
+ */
+auto WavWriter::reset_stats() -> void {
+    if (m_stats) {
+        m_stats->reset();
+    }
+}
+
+/**
+ * @brief Gets the latencies of write calls recorded since the writer was
+ * opened or the latencies were reset.
+ * @return The count, deadline misses and percentiles, all zero when
+ * latencies are not recorded
+ */
+auto WavWriter::get_latency() const -> WavLatencySummary {
+    return m_latency ? m_latency->summary() : WavLatencySummary{};
+}
+
+/**
+ * @brief Forgets the recorded latencies.
+ */
+auto WavWriter::reset_latency() -> void {
+    if (m_latency) {
+        m_latency->reset();
+    }
+}
+
+/**
+ * @brief Builds the chunks written after the data chunk when closing.
+ * @return The bytes of the chunks, including the pad byte of the data chunk
+ */
+auto WavWriter::trailing_chunks() -> std::string {
+    std::string trailing;
+    if (!m_options.storeHash) {
+        return trailing;
+    }
+    /// Chunks start on even offsets
+    if (m_totalFileSize % 2 != 0) {
+        trailing.push_back('\0');
+    }
+    trailing.append(kWavHashChunkId, 4);
+    constexpr uint32_t hashChunkSize = 8;
+    const uint64_t digest = m_hasher.digest();
+    trailing.append(reinterpret_cast<const char *>(&hashChunkSize), 4);
+    trailing.append(reinterpret_cast<const char *>(&digest), 8);
+    m_trailingBytes = static_cast<uint32_t>(trailing.size());
+    return trailing;
 }
 
 /**
@@ -65,14 +201,237 @@ auto WavWriter::close_file() -> void {
  * @return True if the file was opened successfully, false otherwise
  */
 auto WavWriter::open_file() -> bool {
-    m_fileStream.open(m_config.filename, std::ios::binary | std::ios::out);
-    if (!m_fileStream) {
-        return false;
+    m_config.blockAlign = static_cast<uint16_t>(
+            m_config.numChannels *
+            (static_cast<uint16_t>(m_config.bitDepth) / 8));
+    if (m_options.directIo) {
+        m_directFileDescriptor =
+                ::open(m_config.filename.c_str(),
+                       O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    }
+    if (m_directFileDescriptor >= 0) {
+        /// At least two sectors, so a full buffer always holds a whole one
+        m_stagingSize = std::max(2 * kDirectIoAlignment,
+                                 (m_options.stagingBytes +
+                                  kDirectIoAlignment - 1) &
+                                         ~(kDirectIoAlignment - 1));
+        m_staging.reset(static_cast<uint8_t *>(
+                std::aligned_alloc(kDirectIoAlignment, m_stagingSize)));
+        if (!m_staging) {
+            ::close(m_directFileDescriptor);
+            m_directFileDescriptor = -1;
+            return false;
+        }
+        if (m_stats) {
+            m_stats->add_allocations();
+        }
+    } else {
+        m_fileStream.open(m_config.filename,
+                          std::ios::binary | std::ios::out);
+        if (!m_fileStream) {
+            return false;
+        }
     }
     write_header();
+    WAV_TRACE2(writer_open, m_config.filename.c_str(),
+               m_directFileDescriptor >= 0);
     return true;
 }
 
+/**
+ * @brief Gets the writer configuration.
+ * @return The writer configuration
+ */
+auto WavWriter::get_configuration() const -> WavFileConfiguration {
+    return m_config;
+}
+
+/**
+ * @brief Checks whether writes bypass the page cache.
+ * @return True if the file was opened with O_DIRECT, false otherwise
+ */
+auto WavWriter::is_direct_io() const -> bool {
+    return m_directFileDescriptor >= 0;
+}
+
+/**
+ * @brief Checks whether a write to the file failed.
+ * @return True if a write failed, false otherwise
+ */
+auto WavWriter::has_write_error() const -> bool {
+    return m_writeFailed || m_fileStream.fail();
+}
+
+/**
+ * @brief Writes sector-aligned bytes to the O_DIRECT file, retrying without
+ * O_DIRECT if the filesystem rejects them.
+ * @param data The bytes to write
+ * @param byteCount The number of bytes to write
+ * @param offset The offset in the file
+ * @return True if every byte was written, false otherwise
+ */
+auto WavWriter::write_direct_block(const uint8_t *data,
+                                   const size_t byteCount,
+                                   const uint64_t offset) -> bool {
+    if (write_all_at(m_directFileDescriptor, data, byteCount, offset)) {
+        return true;
+    }
+    /// Some filesystems accept O_DIRECT when opening but need a different
+    /// alignment, so retry through the page cache. A full or failing disk
+    /// fails again and is reported.
+    const int flags = ::fcntl(m_directFileDescriptor, F_GETFL);
+    if (flags < 0 || (flags & O_DIRECT) == 0 ||
+        ::fcntl(m_directFileDescriptor, F_SETFL, flags & ~O_DIRECT) < 0) {
+        return false;
+    }
+    return write_all_at(m_directFileDescriptor, data, byteCount, offset);
+}
+
+/**
+ * @brief Copies bytes into the O_DIRECT staging buffer, flushing it whenever
+ * it fills up.
+ * @param data The bytes
+ * @param byteCount The number of bytes
+ */
+auto WavWriter::stage(const uint8_t *data, size_t byteCount) -> void {
+    while (byteCount > 0) {
+        if (m_stagingUsed == m_stagingSize) {
+            flush_staging();
+        }
+        const size_t bytes = std::min(byteCount, m_stagingSize - m_stagingUsed);
+        std::memcpy(m_staging.get() + m_stagingUsed, data, bytes);
+        m_stagingUsed += bytes;
+        data += bytes;
+        byteCount -= bytes;
+    }
+}
+
+/**
+ * @brief Writes the whole sectors of the staging buffer to the file and moves
+ * the partial sector left over to the front of the buffer.
+ */
+auto WavWriter::flush_staging() -> void {
+    const size_t aligned = m_stagingUsed & ~(kDirectIoAlignment - 1);
+    {
+        const WavStatsTimer timer(m_stats.get(), WavStatsPhase::IO);
+        WAV_REALTIME_BLOCKING("pwrite");
+        /// After a failure the rest of the audio is dropped, since writing
+        /// it after a gap would only make the file look complete
+        if (!m_writeFailed &&
+            !write_direct_block(m_staging.get(), aligned, m_directOffset)) {
+            m_writeFailed = true;
+        }
+    }
+    if (m_stats) {
+        m_stats->add_io_call();
+    }
+    std::memmove(m_staging.get(), m_staging.get() + aligned,
+                 m_stagingUsed - aligned);
+    m_stagingUsed -= aligned;
+    m_directOffset += aligned;
+}
+
+/**
+ * @brief Writes the unaligned tail, trims the file to its real size and
+ * patches the header through a buffered descriptor.
+ */
+auto WavWriter::finalize_direct() -> void {
+    const std::string trailing = trailing_chunks();
+    stage(reinterpret_cast<const uint8_t *>(trailing.data()),
+          trailing.size());
+    /// O_DIRECT only writes whole sectors, so pad the tail with zeros and
+    /// cut the file back afterwards
+    const uint64_t fileSize = m_directOffset + m_stagingUsed;
+    const size_t padded = (m_stagingUsed + kDirectIoAlignment - 1) &
+                          ~(kDirectIoAlignment - 1);
+    std::memset(m_staging.get() + m_stagingUsed, 0, padded - m_stagingUsed);
+    {
+        const WavStatsTimer timer(m_stats.get(), WavStatsPhase::IO);
+        if (!m_writeFailed &&
+            !write_direct_block(m_staging.get(), padded, m_directOffset)) {
+            m_writeFailed = true;
+        }
+    }
+    if (m_stats) {
+        m_stats->add_io_call();
+    }
+    if (!m_writeFailed &&
+        ::ftruncate(m_directFileDescriptor, static_cast<off_t>(fileSize)) <
+                0) {
+        m_writeFailed = true;
+    }
+    ::close(m_directFileDescriptor);
+    m_directFileDescriptor = -1;
+    m_staging.reset();
+    m_stagingUsed = 0;
+    /// Leave the placeholder sizes, so the file reads as unfinalized rather
+    /// than claiming audio that never reached the disk
+    if (m_writeFailed) {
+        return;
+    }
+
+    /// The sizes are a few unaligned bytes, so patch them without O_DIRECT
+    const int fd = ::open(m_config.filename.c_str(), O_WRONLY);
+    if (fd < 0) {
+        m_writeFailed = true;
+        return;
+    }
+    const auto chunkSize = static_cast<uint32_t>(
+            m_headerLayout.dataOffset - 8 + m_totalFileSize +
+            m_trailingBytes);
+    if (!write_all_at(fd, reinterpret_cast<const uint8_t *>(&chunkSize), 4,
+                      m_headerLayout.riffSizeOffset) ||
+        !write_all_at(fd, reinterpret_cast<const uint8_t *>(&m_totalFileSize),
+                      4, m_headerLayout.dataSizeOffset)) {
+        m_writeFailed = true;
+    }
+    ::close(fd);
+    WAV_TRACE3(writer_finalize, this, m_totalFileSize, m_trailingBytes);
+}
+
+/**
+ * @brief Opens an existing WAV file for appending.
+ * @return True if the file was opened successfully and its header matches the
+ * configuration, false otherwise
+ */
+auto WavWriter::open_existing_file() -> bool {
+    std::ifstream input(m_config.filename, std::ios::binary | std::ios::in);
+    if (!input) {
+        return false;
+    }
+    WavFileConfiguration existing;
+    const auto layout = read_wav_header(input, existing);
+    if (!layout) {
+        return false;
+    }
+    if (existing.format != m_config.format ||
+        existing.bitDepth != m_config.bitDepth ||
+        existing.numChannels != m_config.numChannels ||
+        existing.sampleRate != m_config.sampleRate) {
+        return false;
+    }
+    /// The data chunk must be the last chunk, optionally followed by its pad
+    /// byte, otherwise appending would overwrite the chunks that follow it
+    input.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(input.tellg());
+    const uint64_t dataEnd = layout->dataOffset + existing.dataChunkSize;
+    if (fileSize != dataEnd && fileSize != dataEnd + 1) {
+        return false;
+    }
+    input.close();
+
+    m_fileStream.open(m_config.filename,
+                      std::ios::binary | std::ios::in | std::ios::out);
+    if (!m_fileStream) {
+        return false;
+    }
+    m_fileStream.seekp(static_cast<std::streamoff>(dataEnd), std::ios::beg);
+    m_config.blockAlign = existing.blockAlign;
+    m_totalFileSize = existing.dataChunkSize;
+    m_headerLayout = *layout;
+    return static_cast<bool>(m_fileStream);
+}
+
 /**
  * @brief Write the WAV file header.
  */
@@ -80,36 +439,56 @@ auto WavWriter::write_header() -> void {
     const auto sampleRate = static_cast<uint32_t>(m_config.sampleRate);
     const auto numChannels = static_cast<uint16_t>(m_config.numChannels);
     const auto bitDepth = static_cast<uint16_t>(m_config.bitDepth);
+    /// With O_DIRECT the header goes through the staging buffer
+    std::ostringstream staged;
+    std::ostream &out = m_directFileDescriptor >= 0
+                                ? static_cast<std::ostream &>(staged)
+                                : m_fileStream;
     // Write the initial header with placeholder values
-    m_fileStream.write("RIFF", 4);
+    out.write("RIFF", 4);
     constexpr uint32_t chunkSize = 0;
-    m_fileStream.write(reinterpret_cast<const char *>(&chunkSize), 4);
-    m_fileStream.write("WAVE", 4);
-    m_fileStream.write("fmt ", 4);
+    out.write(reinterpret_cast<const char *>(&chunkSize), 4);
+    out.write("WAVE", 4);
+    out.write("fmt ", 4);
     constexpr uint32_t subchunk1Size = 16;
-    m_fileStream.write(reinterpret_cast<const char *>(&subchunk1Size), 4);
+    out.write(reinterpret_cast<const char *>(&subchunk1Size), 4);
     const auto audioFormat = static_cast<uint16_t>(m_config.format);
-    m_fileStream.write(reinterpret_cast<const char *>(&audioFormat), 2);
-    m_fileStream.write(reinterpret_cast<const char *>(&numChannels), 2);
-    m_fileStream.write(reinterpret_cast<const char *>(&sampleRate), 4);
+    out.write(reinterpret_cast<const char *>(&audioFormat), 2);
+    out.write(reinterpret_cast<const char *>(&numChannels), 2);
+    out.write(reinterpret_cast<const char *>(&sampleRate), 4);
     const uint32_t byteRate = sampleRate * numChannels * (bitDepth / 8);
-    m_fileStream.write(reinterpret_cast<const char *>(&byteRate), 4);
+    out.write(reinterpret_cast<const char *>(&byteRate), 4);
     const uint16_t blockAlign = numChannels * (bitDepth / 8);
-    m_fileStream.write(reinterpret_cast<const char *>(&blockAlign), 2);
-    m_fileStream.write(reinterpret_cast<const char *>(&bitDepth), 2);
-    m_fileStream.write("data", 4);
+    out.write(reinterpret_cast<const char *>(&blockAlign), 2);
+    out.write(reinterpret_cast<const char *>(&bitDepth), 2);
+    out.write("data", 4);
     constexpr uint32_t subchunk2Size = 0;
-    m_fileStream.write(reinterpret_cast<const char *>(&subchunk2Size), 4);
+    out.write(reinterpret_cast<const char *>(&subchunk2Size), 4);
+    if (m_directFileDescriptor >= 0) {
+        const std::string header = staged.str();
+        stage(reinterpret_cast<const uint8_t *>(header.data()),
+              header.size());
+    }
 }
 
 /**
  * @brief Finalize the WAV file header.
  */
 auto WavWriter::finalize_header() -> void {
+    if (m_stats) {
+        m_stats->add_seeks(2);
+    }
     /// Update the RIFF chunk size and data subchunk size
-    const uint32_t chunkSize = 36 + m_totalFileSize;
-    m_fileStream.seekp(4, std::ios::beg);
+    const auto chunkSize = static_cast<uint32_t>(
+            m_headerLayout.dataOffset - 8 + m_totalFileSize +
+            m_trailingBytes);
+    m_fileStream.seekp(
+            static_cast<std::streamoff>(m_headerLayout.riffSizeOffset),
+            std::ios::beg);
     m_fileStream.write(reinterpret_cast<const char *>(&chunkSize), 4);
-    m_fileStream.seekp(40, std::ios::beg);
+    m_fileStream.seekp(
+            static_cast<std::streamoff>(m_headerLayout.dataSizeOffset),
+            std::ios::beg);
     m_fileStream.write(reinterpret_cast<const char *>(&m_totalFileSize), 4);
+    WAV_TRACE3(writer_finalize, this, m_totalFileSize, m_trailingBytes);
 }
\ No newline at end of file
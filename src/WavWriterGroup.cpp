@@ -0,0 +1,145 @@
+/// WavWriterGroup.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavWriterGroup.h>
+
+#include <AudioFileTools/WavRealtime.h>
+
+#include <filesystem>
+
+/**
+ * @brief Public constructor that creates the WAV files.
+ * @param configurations The configuration of each file
+ * @param options The group options
+ * @return A writer group object if every file was created, std::nullopt
+ * otherwise
+ */
+auto WavWriterGroup::create(
+        const std::vector<WavFileConfiguration> &configurations,
+        const WavWriterGroupOptions options) -> std::optional<WavWriterGroup> {
+    if (configurations.empty()) {
+        return std::nullopt;
+    }
+    /// Two buffers per file share the budget
+    const size_t bufferBytes =
+            options.maxBufferedBytes / (2 * configurations.size());
+    auto obj = WavWriterGroup();
+    for (const auto &configuration : configurations) {
+        auto writer = WavWriter::create(configuration);
+        if (!writer) {
+            /// Do not leave the files created so far behind as empty
+            /// recordings
+            for (const auto &track : obj.m_tracks) {
+                track->writer.close_file();
+                std::filesystem::remove(track->config.filename);
+            }
+            return std::nullopt;
+        }
+        auto config = configuration;
+        config.blockAlign = static_cast<uint16_t>(
+                config.numChannels *
+                (static_cast<uint16_t>(config.bitDepth) / 8));
+        /// Round down to whole frames, but hold at least one
+        const size_t frames =
+                std::max<size_t>(1, bufferBytes / config.blockAlign);
+        obj.m_tracks.push_back(std::make_unique<Track>(
+                config, std::move(*writer), frames * config.blockAlign));
+    }
+    obj.m_pool = std::make_unique<WavThreadPool>(options.numThreads);
+    return obj;
+}
+
+/**
+ * @brief Public destructor
+ */
+WavWriterGroup::~WavWriterGroup() {
+    if (m_pool) {
+        close();
+    }
+}
+
+/**
+ * @brief Flushes the remaining buffers and closes every file.
+ */
+auto WavWriterGroup::close() -> void {
+    if (!m_pool) {
+        return;
+    }
+    for (const auto &track : m_tracks) {
+        if (track->filled > 0) {
+            flush_track(*track);
+        }
+    }
+    m_pool->wait();
+    m_pool.reset();
+    for (const auto &track : m_tracks) {
+        track->writer.close_file();
+    }
+}
+
+/**
+ * @brief Gets the number of files in the group.
+ * @return The number of files
+ */
+auto WavWriterGroup::size() const -> size_t { return m_tracks.size(); }
+
+/**
+ * @brief Gets the total number of channels across all files.
+ * @return The number of channels
+ */
+auto WavWriterGroup::num_channels() const -> size_t {
+    size_t channels = 0;
+    for (const auto &track : m_tracks) {
+        channels += track->config.numChannels;
+    }
+    return channels;
+}
+
+/**
+ * @brief Hands a file's filling buffer to the I/O pool, once its previous
+ * flush has finished.
+ * @param track The file
+ */
+auto WavWriterGroup::flush_track(Track &track) -> void {
+    {
+        WAV_REALTIME_BLOCKING("std::mutex::lock");
+        std::unique_lock lock(track.mutex);
+        track.flushed.wait(lock, [&track] { return !track.inFlight; });
+        track.inFlight = true;
+    }
+    std::swap(track.filling, track.flushing);
+    const size_t bytes = track.filled;
+    track.filled = 0;
+    /// Queuing the task takes the pool's locks and wakes a worker
+    WAV_REALTIME_BLOCKING("WavThreadPool::submit");
+    m_pool->submit([&track, bytes] {
+        track.writer.write_encoded(track.flushing.data(), bytes);
+        {
+            std::lock_guard lock(track.mutex);
+            track.inFlight = false;
+        }
+        track.flushed.notify_one();
+    });
+}
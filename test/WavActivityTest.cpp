@@ -0,0 +1,133 @@
+/// WavActivityTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavActivity.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavVerify.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a mono file with tones over [1000, 3000), a short click at
+ * [6000, 6100) and a tone over [7000, 9000), and silence elsewhere.
+ */
+auto write_speech(const std::string &filename, const WavBitDepth bitDepth,
+                  const WavFormat format) -> void {
+    std::vector<float> samples(10000, 0.0f);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if ((i >= 1000 && i < 3000) || (i >= 6000 && i < 6100) ||
+            (i >= 7000 && i < 9000)) {
+            samples[i] = 0.5f * std::sin(static_cast<float>(i) * 0.3f);
+        }
+    }
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate =
+                                             WavSampleRate::SAMPLE_RATE_16000,
+                                     .numChannels = 1,
+                                     .bitDepth = bitDepth,
+                                     .format = format});
+    ASSERT_TRUE(writer.has_value());
+    writer->write(samples.size(), samples.data());
+    writer->close_file();
+}
+
+const WavActivityOptions kOptions = {.windowFrames = 100,
+                                     .minSilenceFrames = 800,
+                                     .minActiveFrames = 500};
+
+const std::vector<WavActivityRegion> kExpected = {{.start = 1000, .length = 2000},
+                                                  {.start = 7000, .length = 2000}};
+} // namespace
+
+TEST(WavActivityTest, DetectsRegionsInEachFormat) {
+    const std::string filename = "activity-formats.wav";
+    for (const auto &[bitDepth, format] :
+         {std::pair{WavBitDepth::BIT_DEPTH_8, WavFormat::PCM},
+          std::pair{WavBitDepth::BIT_DEPTH_16, WavFormat::PCM},
+          std::pair{WavBitDepth::BIT_DEPTH_24, WavFormat::PCM},
+          std::pair{WavBitDepth::BIT_DEPTH_32, WavFormat::PCM},
+          std::pair{WavBitDepth::BIT_DEPTH_32, WavFormat::FLOAT}}) {
+        write_speech(filename, bitDepth, format);
+        const auto regions = detect_wav_activity(filename, kOptions);
+        ASSERT_TRUE(regions.has_value());
+        EXPECT_EQ(*regions, kExpected) << static_cast<int>(bitDepth);
+    }
+    std::filesystem::remove(filename);
+}
+
+TEST(WavActivityTest, ShortSilencesAreBridged) {
+    const std::string filename = "activity-bridge.wav";
+    write_speech(filename, WavBitDepth::BIT_DEPTH_16, WavFormat::PCM);
+    auto options = kOptions;
+    options.minSilenceFrames = 5000;
+    const auto regions = detect_wav_activity(filename, options);
+    ASSERT_TRUE(regions.has_value());
+    const std::vector<WavActivityRegion> expected = {
+            {.start = 1000, .length = 8000}};
+    EXPECT_EQ(*regions, expected);
+    std::filesystem::remove(filename);
+}
+
+TEST(WavActivityTest, IndexRoundTripsAndKeepsFileValid) {
+    const std::string filename = "activity-index.wav";
+    write_speech(filename, WavBitDepth::BIT_DEPTH_16, WavFormat::PCM);
+    EXPECT_FALSE(read_wav_activity_index(filename).has_value());
+    const auto regions = detect_wav_activity(filename, kOptions);
+    ASSERT_TRUE(regions.has_value());
+    ASSERT_TRUE(write_wav_activity_index(filename, *regions));
+
+    const auto index = read_wav_activity_index(filename);
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(*index, kExpected);
+    EXPECT_TRUE(verify_wav_file(filename).valid());
+
+    /// Seek straight to the second region
+    auto reader = WavReader::create(filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(reader->get_configuration().num_samples(), 10000u);
+    ASSERT_TRUE(reader->seek_frame(index->back().start));
+    const auto samples = reader->read<float>(1);
+    EXPECT_NE(samples[0][0], 0.0f);
+    std::filesystem::remove(filename);
+}
+
+TEST(WavActivityTest, ReindexingReplacesRegions) {
+    const std::string filename = "activity-reindex.wav";
+    write_speech(filename, WavBitDepth::BIT_DEPTH_16, WavFormat::PCM);
+    const auto size = std::filesystem::file_size(filename);
+    const std::vector<WavActivityRegion> first = {{.start = 0, .length = 10},
+                                                  {.start = 100,
+                                                   .length = 10}};
+    const std::vector<WavActivityRegion> second = {{.start = 500,
+                                                    .length = 20}};
+    ASSERT_TRUE(write_wav_activity_index(filename, first));
+    const auto indexedSize = std::filesystem::file_size(filename);
+    ASSERT_TRUE(write_wav_activity_index(filename, second));
+    EXPECT_EQ(read_wav_activity_index(filename), second);
+    EXPECT_LT(std::filesystem::file_size(filename), indexedSize);
+    EXPECT_TRUE(verify_wav_file(filename).valid());
+
+    /// An empty index leaves no regions behind
+    ASSERT_TRUE(write_wav_activity_index(filename, {}));
+    EXPECT_EQ(read_wav_activity_index(filename),
+              std::vector<WavActivityRegion>{});
+    EXPECT_GT(std::filesystem::file_size(filename), size);
+    EXPECT_FALSE(WavWriter::open_append({.filename = filename,
+                                         .sampleRate =
+                                                 WavSampleRate::SAMPLE_RATE_16000,
+                                         .numChannels = 1,
+                                         .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                                         .format = WavFormat::PCM})
+                         .has_value());
+    std::filesystem::remove(filename);
+}
+
+TEST(WavActivityTest, MissingFileFails) {
+    EXPECT_FALSE(detect_wav_activity("missing-activity.wav").has_value());
+    EXPECT_FALSE(write_wav_activity_index("missing-activity.wav", {}));
+}
@@ -0,0 +1,102 @@
+/// WavAsyncTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavAsync.h>
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <latch>
+#include <vector>
+
+namespace {
+/** Minimal eagerly started coroutine that signals a promise when done */
+struct DetachedTask {
+    struct promise_type {
+        auto get_return_object() -> DetachedTask { return {}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        auto return_void() -> void {}
+        auto unhandled_exception() -> void { std::terminate(); }
+    };
+};
+
+auto write_then_read(WavThreadPool &pool, const WavFileConfiguration config,
+                     const std::vector<int16_t> &samples,
+                     std::promise<std::vector<std::vector<float>>> &done)
+        -> DetachedTask {
+    {
+        auto writer = WavWriter::create(config);
+        if (!writer) {
+            ADD_FAILURE() << "Could not create " << config.filename;
+            done.set_value({});
+            co_return;
+        }
+        const int16_t *const sampleArrays[] = {samples.data()};
+        co_await async_write(pool, *writer, sampleArrays, samples.size());
+        writer->close_file();
+    }
+    auto reader = WavReader::create(config.filename);
+    if (!reader) {
+        ADD_FAILURE() << "Could not open " << config.filename;
+        done.set_value({});
+        co_return;
+    }
+    done.set_value(co_await async_read<float>(pool, *reader, samples.size()));
+}
+
+auto read_at_then_count_down(WavThreadPool &pool, const WavReader &reader,
+                             const size_t frame, float *const *sampleArrays,
+                             size_t &framesRead, std::latch &finished)
+        -> DetachedTask {
+    framesRead = co_await async_read_at(pool, reader, frame, 100,
+                                        sampleArrays);
+    finished.count_down();
+}
+} // namespace
+
+TEST(WavAsyncTest, AwaitWriteAndRead) {
+    const WavFileConfiguration config = {
+            .filename = "pcm16-async.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_16000,
+            .numChannels = 1,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    std::vector<int16_t> samples(16000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<int16_t>(i);
+    }
+    WavThreadPool pool(2);
+    std::promise<std::vector<std::vector<float>>> done;
+    auto result = done.get_future();
+    write_then_read(pool, config, samples, done);
+    const auto readSamples = result.get();
+    ASSERT_EQ(1u, readSamples.size());
+    ASSERT_EQ(samples.size(), readSamples[0].size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_FLOAT_EQ(convert_int16_to_float(samples[i]), readSamples[0][i]);
+    }
+
+    /// Positional reads of the same reader can be in flight together, so
+    /// both are started before either is waited for
+    const auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    std::vector<float> head(100);
+    std::vector<float> tail(100);
+    float *const headArrays[] = {head.data()};
+    float *const tailArrays[] = {tail.data()};
+    size_t headRead = 0;
+    size_t tailRead = 0;
+    std::latch finished(2);
+    read_at_then_count_down(pool, *reader, 0, headArrays, headRead, finished);
+    read_at_then_count_down(pool, *reader, samples.size() - 100, tailArrays,
+                            tailRead, finished);
+    finished.wait();
+    EXPECT_EQ(100u, headRead);
+    EXPECT_EQ(100u, tailRead);
+    EXPECT_EQ(readSamples[0][0], head[0]);
+    EXPECT_EQ(readSamples[0].back(), tail.back());
+    pool.wait();
+    std::remove(config.filename.c_str());
+}
@@ -0,0 +1,78 @@
+/// WavBatchTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavBatch.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+TEST(WavBatchTest, ConvertManyFiles) {
+    constexpr size_t numFiles = 12;
+    constexpr size_t numFrames = 20000;
+    std::vector<float> left(numFrames);
+    std::vector<float> right(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        left[i] = static_cast<float>(
+                0.5 * std::sin(2.0 * M_PI * static_cast<double>(i) / 480.0));
+        right[i] = -left[i];
+    }
+    const WavBitDepth inputDepths[] = {WavBitDepth::BIT_DEPTH_16,
+                                       WavBitDepth::BIT_DEPTH_24,
+                                       WavBitDepth::BIT_DEPTH_32};
+    std::vector<WavBatchJob> jobs;
+    for (size_t i = 0; i < numFiles; ++i) {
+        const WavFileConfiguration input = {
+                .filename = "batch-in-" + std::to_string(i) + ".wav",
+                .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                .numChannels = 2,
+                .bitDepth = inputDepths[i % 3],
+                .format = WavFormat::PCM,
+        };
+        auto writer = WavWriter::create(input);
+        ASSERT_TRUE(writer.has_value());
+        writer->write(numFrames, left.data(), right.data());
+        writer->close_file();
+        jobs.push_back({
+                .input = input.filename,
+                .output = {
+                        .filename = "batch-out-" + std::to_string(i) + ".wav",
+                        .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                        .numChannels = 2,
+                        .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                        .format = WavFormat::FLOAT,
+                },
+        });
+    }
+    /// A job whose input is missing must fail on its own
+    jobs.push_back({.input = "batch-missing.wav", .output = jobs[0].output});
+    jobs.back().output.filename = "batch-out-missing.wav";
+    /// So must a job whose output device is full
+    jobs.push_back({.input = jobs[0].input, .output = jobs[0].output});
+    jobs.back().output.filename = "/dev/full";
+
+    /// A small budget forces each job through many blocks
+    WavBatchConverter converter({.numThreads = 4, .maxInFlightBytes = 1 << 16});
+    const auto results = converter.convert(jobs);
+    ASSERT_EQ(jobs.size(), results.size());
+    EXPECT_FALSE(results[numFiles].success);
+    EXPECT_FALSE(results[numFiles + 1].success);
+    for (size_t i = 0; i < numFiles; ++i) {
+        ASSERT_TRUE(results[i].success);
+        EXPECT_EQ(numFrames, results[i].frames);
+        EXPECT_GT(results[i].runTime.count(), 0);
+        auto reader = WavReader::create(jobs[i].output.filename);
+        ASSERT_TRUE(reader.has_value());
+        const auto samples = reader->read<float>(numFrames);
+        ASSERT_EQ(numFrames, samples[0].size());
+        for (size_t j = 0; j < numFrames; ++j) {
+            EXPECT_NEAR(left[j], samples[0][j], 0.001);
+            EXPECT_NEAR(right[j], samples[1][j], 0.001);
+        }
+        reader->close_file();
+        std::remove(jobs[i].input.c_str());
+        std::remove(jobs[i].output.filename.c_str());
+    }
+}
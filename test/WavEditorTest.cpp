@@ -0,0 +1,55 @@
+/// WavEditorTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavEditor.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(WavEditorTest, OverwriteRegionInPlace) {
+    const WavFileConfiguration config = {
+            .filename = "pcm16-edit.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    std::vector<int16_t> left(10000);
+    std::vector<int16_t> right(10000);
+    for (size_t i = 0; i < 10000; ++i) {
+        left[i] = static_cast<int16_t>(i);
+        right[i] = static_cast<int16_t>(-static_cast<int>(i));
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(left.size(), left.data(), right.data());
+    writer->close_file();
+    /// Punch in half a scale float region across a page boundary
+    auto editor = WavEditor::create(config.filename);
+    ASSERT_TRUE(editor.has_value());
+    std::vector<float> patch(3000, 0.5f);
+    EXPECT_TRUE(editor->overwrite(2000, patch.size(), patch.data(),
+                                  patch.data()));
+    /// Ranges past the end of the data chunk must be rejected
+    EXPECT_FALSE(editor->overwrite(9000, patch.size(), patch.data(),
+                                   patch.data()));
+    /// Including ranges whose end overflows size_t
+    EXPECT_FALSE(editor->overwrite(2, SIZE_MAX, patch.data(), patch.data()));
+    editor->close_file();
+    /// Now read it back
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(10000u, reader->get_configuration().num_samples());
+    const auto readSamples = reader->read<int16_t>(10000);
+    ASSERT_EQ(10000u, readSamples[0].size());
+    const auto patched = convert_float_to_int16(0.5f);
+    for (size_t i = 0; i < 10000; ++i) {
+        const bool inPatch = i >= 2000 && i < 5000;
+        EXPECT_EQ(inPatch ? patched : left[i], readSamples[0][i]);
+        EXPECT_EQ(inPatch ? patched : right[i], readSamples[1][i]);
+    }
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
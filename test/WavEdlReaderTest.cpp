@@ -0,0 +1,98 @@
+/// WavEdlReaderTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavEdlReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a mono float file holding a ramp scaled by a factor.
+ */
+auto write_ramp(const std::string &filename, const size_t frames,
+                const float scale) -> void {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = scale * static_cast<float>(i) / 10000.0f;
+    }
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                                     .numChannels = 1,
+                                     .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                                     .format = WavFormat::FLOAT});
+    ASSERT_TRUE(writer.has_value());
+    writer->write(frames, samples.data());
+    writer->close_file();
+}
+} // namespace
+
+TEST(WavEdlReaderTest, StitchesRegionsWithCrossfade) {
+    write_ramp("edl-source-a.wav", 1000, 1.0f);
+    write_ramp("edl-source-b.wav", 1000, -1.0f);
+    auto edl = WavEdlReader::create(
+            {{.filename = "edl-source-a.wav", .sourceStart = 100, .length = 500},
+             {.filename = "edl-source-b.wav",
+              .sourceStart = 0,
+              .length = 400,
+              .gain = 2.0f,
+              .crossfade = 100},
+             {.filename = "edl-missing.wav", .length = 50}},
+            WavSampleRate::SAMPLE_RATE_48000, 1);
+    ASSERT_TRUE(edl.has_value());
+    ASSERT_EQ(edl->num_frames(), 850);
+
+    /// Read in blocks that straddle region boundaries
+    std::vector<float> output;
+    while (true) {
+        const auto block = edl->read<float>(37);
+        if (block[0].empty()) {
+            break;
+        }
+        output.insert(output.end(), block[0].begin(), block[0].end());
+    }
+    ASSERT_EQ(output.size(), 850);
+    const auto a = [](const size_t i) { return (100.0f + i) / 10000.0f; };
+    const auto b = [](const size_t i) { return -2.0f * i / 10000.0f; };
+    for (size_t t = 0; t < 400; ++t) {
+        ASSERT_NEAR(output[t], a(t), 1e-6f) << t;
+    }
+    for (size_t k = 0; k < 100; ++k) {
+        const float fadeIn = (k + 1.0f) / 101.0f;
+        ASSERT_NEAR(output[400 + k],
+                    (1.0f - fadeIn) * a(400 + k) + fadeIn * b(k), 1e-6f)
+                << k;
+    }
+    for (size_t t = 500; t < 800; ++t) {
+        ASSERT_NEAR(output[t], b(t - 400), 1e-6f) << t;
+    }
+    for (size_t t = 800; t < 850; ++t) {
+        ASSERT_EQ(output[t], 0.0f) << t;
+    }
+    EXPECT_EQ(edl->failed_regions(), 1);
+
+    /// Seeking reads the same samples again
+    ASSERT_TRUE(edl->seek_frame(450));
+    const auto again = edl->read<float>(10);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(again[0][i], output[450 + i]);
+    }
+    std::remove("edl-source-a.wav");
+    std::remove("edl-source-b.wav");
+}
+
+TEST(WavEdlReaderTest, RejectsOverlongCrossfade) {
+    EXPECT_FALSE(WavEdlReader::create({{.filename = "a.wav", .length = 100},
+                                       {.filename = "b.wav",
+                                        .length = 100,
+                                        .crossfade = 101}},
+                                      WavSampleRate::SAMPLE_RATE_48000, 1)
+                         .has_value());
+    EXPECT_FALSE(WavEdlReader::create({{.filename = "a.wav",
+                                        .length = 100,
+                                        .crossfade = 10}},
+                                      WavSampleRate::SAMPLE_RATE_48000, 1)
+                         .has_value());
+}
@@ -0,0 +1,75 @@
+/// WavGraphTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavGraph.h>
+
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+TEST(WavGraphTest, FusesElementwiseStages) {
+    constexpr size_t totalFrames = 10000;
+    std::vector<float> left(totalFrames);
+    std::vector<float> right(totalFrames);
+    for (size_t i = 0; i < totalFrames; ++i) {
+        left[i] = static_cast<float>(i) / totalFrames;
+        right[i] = -0.1f;
+    }
+    {
+        auto writer = WavWriter::create(
+                {.filename = "graph-input.wav",
+                 .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                 .numChannels = 2,
+                 .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                 .format = WavFormat::FLOAT});
+        ASSERT_TRUE(writer.has_value());
+        writer->write(totalFrames, left.data(), right.data());
+    }
+
+    auto reader = WavReader::create("graph-input.wav");
+    ASSERT_TRUE(reader.has_value());
+    WavReaderSource source(std::move(*reader));
+    auto graph = fuse(fuse(source, WavGain{.gain = 2.0f}),
+                      WavClip{.limit = 0.5f}, WavPeakMeter{});
+    static_assert(std::is_same_v<decltype(graph),
+                                 WavElementwiseNode<WavGain, WavClip,
+                                                    WavPeakMeter>>);
+    EXPECT_EQ(graph.num_channels(), 2);
+
+    /// A writer with a different channel count is refused
+    {
+        auto mono = WavWriter::create(
+                {.filename = "graph-mono.wav",
+                 .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                 .numChannels = 1,
+                 .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                 .format = WavFormat::FLOAT});
+        ASSERT_TRUE(mono.has_value());
+        EXPECT_EQ(run_graph(graph, *mono, 512), 0u);
+    }
+    std::remove("graph-mono.wav");
+
+    auto writer = WavWriter::create(
+            {.filename = "graph-output.wav",
+             .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+             .numChannels = 2,
+             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+             .format = WavFormat::FLOAT});
+    ASSERT_TRUE(writer.has_value());
+    EXPECT_EQ(run_graph(graph, *writer, 512), totalFrames);
+    writer->close_file();
+    EXPECT_FLOAT_EQ(graph.op<2>().peaks[0], 0.5f);
+    EXPECT_FLOAT_EQ(graph.op<2>().peaks[1], 0.2f);
+
+    auto output = WavReader::create("graph-output.wav");
+    ASSERT_TRUE(output.has_value());
+    const auto samples = output->read<float>(totalFrames);
+    ASSERT_EQ(samples[0].size(), totalFrames);
+    for (size_t i = 0; i < totalFrames; ++i) {
+        ASSERT_FLOAT_EQ(samples[0][i], std::min(2.0f * left[i], 0.5f));
+        ASSERT_FLOAT_EQ(samples[1][i], -0.2f);
+    }
+    std::remove("graph-input.wav");
+    std::remove("graph-output.wav");
+}
@@ -0,0 +1,89 @@
+/// WavHashTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavHash.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Hashes a string in one call.
+ */
+auto hash_string(const std::string &text) -> uint64_t {
+    WavHasher hasher;
+    hasher.update(text.data(), text.size());
+    return hasher.digest();
+}
+} // namespace
+
+TEST(WavHashTest, MatchesReferenceDigests) {
+    EXPECT_EQ(hash_string(""), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(hash_string("a"), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(hash_string("abc"), 0x44BC2CF5AD770999ULL);
+    EXPECT_EQ(hash_string("Nobody inspects the spammish repetition"),
+              0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(WavHashTest, StreamingMatchesOneShot) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    WavHasher oneShot;
+    oneShot.update(data.data(), data.size());
+    for (const size_t step : {1, 3, 7, 31, 32, 33, 100}) {
+        WavHasher hasher;
+        for (size_t offset = 0; offset < data.size(); offset += step) {
+            hasher.update(data.data() + offset,
+                          std::min(step, data.size() - offset));
+        }
+        EXPECT_EQ(hasher.digest(), oneShot.digest()) << step;
+    }
+}
+
+TEST(WavHashTest, WriterStoresPayloadHash) {
+    /// An odd payload size, so the hash chunk follows a pad byte
+    constexpr size_t numFrames = 1001;
+    std::vector<uint8_t> samples(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        samples[i] = static_cast<uint8_t>(i);
+    }
+    for (const bool directIo : {false, true}) {
+        const WavFileConfiguration config = {
+                .filename = "pcm8-hash.wav",
+                .sampleRate = WavSampleRate::SAMPLE_RATE_8000,
+                .numChannels = 1,
+                .bitDepth = WavBitDepth::BIT_DEPTH_8,
+                .format = WavFormat::PCM};
+        auto writer = WavWriter::create(
+                config, {.directIo = directIo, .storeHash = true});
+        ASSERT_TRUE(writer.has_value());
+        writer->write(500, samples.data());
+        writer->write(numFrames - 500, samples.data() + 500);
+        writer->close_file();
+        const uint64_t digest = writer->get_payload_hash();
+
+        WavHasher expected;
+        expected.update(samples.data(), samples.size());
+        EXPECT_EQ(digest, expected.digest());
+        EXPECT_EQ(read_wav_stored_hash(config.filename), digest);
+        EXPECT_EQ(hash_wav_payload(config.filename), digest);
+
+        /// A sequential read computes the same hash on the way
+        auto reader = WavReader::create(config.filename);
+        ASSERT_TRUE(reader.has_value());
+        EXPECT_EQ(reader->get_configuration().num_samples(), numFrames);
+        reader->read<uint8_t>(300);
+        EXPECT_FALSE(reader->get_payload_hash().has_value());
+        reader->read<uint8_t>(numFrames);
+        EXPECT_EQ(reader->get_payload_hash(), digest);
+        /// The stored hash stops appends, which would invalidate it
+        EXPECT_FALSE(WavWriter::open_append(config).has_value());
+        reader->close_file();
+        std::remove(config.filename.c_str());
+    }
+}
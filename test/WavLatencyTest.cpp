@@ -0,0 +1,94 @@
+/// WavLatencyTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavLatency.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+const WavFileConfiguration kConfig = {
+        .filename = "latency.wav",
+        .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+        .numChannels = 1,
+        .bitDepth = WavBitDepth::BIT_DEPTH_16,
+        .format = WavFormat::PCM};
+} // namespace
+
+TEST(WavLatencyTest, PercentilesAreWithinBucketPrecision) {
+    WavLatencyHistogram histogram(5000);
+    for (uint64_t ns = 1; ns <= 10000; ++ns) {
+        histogram.record(ns);
+    }
+    const WavLatencySummary summary = histogram.summary();
+    EXPECT_EQ(summary.count, 10000u);
+    EXPECT_EQ(summary.deadlineMisses, 5000u);
+    EXPECT_EQ(summary.max, 10000u);
+    EXPECT_NEAR(static_cast<double>(summary.p50), 5000.0, 5000.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 9900.0, 9900.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(summary.p999), 9990.0, 9990.0 * 0.04);
+    EXPECT_GE(summary.p50, 5000u);
+    EXPECT_LE(summary.p999, summary.max);
+}
+
+TEST(WavLatencyTest, SmallAndHugeLatencies) {
+    WavLatencyHistogram histogram;
+    histogram.record(0);
+    histogram.record(17);
+    histogram.record(uint64_t{1} << 50);
+    EXPECT_EQ(histogram.percentile(0.0), 0u);
+    EXPECT_EQ(histogram.percentile(50.0), 17u);
+    EXPECT_EQ(histogram.percentile(100.0), uint64_t{1} << 50);
+    EXPECT_EQ(histogram.summary().deadlineMisses, 0u);
+    histogram.reset();
+    EXPECT_EQ(histogram.summary().count, 0u);
+    EXPECT_EQ(histogram.percentile(99.0), 0u);
+}
+
+TEST(WavLatencyTest, BlockPeriod) {
+    EXPECT_EQ(wav_block_period(kConfig, 480), 10'000'000u);
+    EXPECT_EQ(wav_block_period(kConfig, 48000), 1'000'000'000u);
+}
+
+TEST(WavLatencyTest, WriterAndReaderCountDeadlineMisses) {
+    const std::vector<float> block(480, 0.5f);
+    {
+        /// A 1 ns deadline is always missed, a block period never is here
+        auto tight = WavWriter::create(
+                kConfig, {.trackLatency = true, .deadlineNanoseconds = 1});
+        ASSERT_TRUE(tight.has_value());
+        for (int i = 0; i < 20; ++i) {
+            tight->write(block.size(), block.data());
+        }
+        const WavLatencySummary summary = tight->get_latency();
+        EXPECT_EQ(summary.count, 20u);
+        EXPECT_EQ(summary.deadlineMisses, 20u);
+        EXPECT_GT(summary.max, 0u);
+        EXPECT_LE(summary.p50, summary.p99);
+        tight->reset_latency();
+        EXPECT_EQ(tight->get_latency().count, 0u);
+    }
+
+    auto reader = WavReader::create(
+            kConfig.filename,
+            {.trackLatency = true,
+             .deadlineNanoseconds = wav_block_period(kConfig, 480) * 100});
+    ASSERT_TRUE(reader.has_value());
+    std::vector<int16_t> samples(480);
+    const std::array<int16_t *, 1> arrays = {samples.data()};
+    while (reader->read_into(samples.size(), arrays.data()) > 0) {
+    }
+    const WavLatencySummary summary = reader->get_latency();
+    EXPECT_EQ(summary.count, 21u);
+    EXPECT_EQ(summary.deadlineMisses, 0u);
+
+    auto untracked = WavReader::create(kConfig.filename);
+    ASSERT_TRUE(untracked.has_value());
+    untracked->read_into(samples.size(), arrays.data());
+    EXPECT_EQ(untracked->get_latency().count, 0u);
+    std::filesystem::remove(kConfig.filename);
+}
@@ -0,0 +1,88 @@
+/// WavMixerTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavMixer.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a float file where every channel holds the same constant.
+ */
+auto write_constant(const std::string &filename, const uint8_t numChannels,
+                    const size_t frames, const float value) -> void {
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate =
+                                             WavSampleRate::SAMPLE_RATE_48000,
+                                     .numChannels = numChannels,
+                                     .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                                     .format = WavFormat::FLOAT});
+    ASSERT_TRUE(writer.has_value());
+    const std::vector<float> samples(frames, value);
+    std::vector<const float *> channels(numChannels, samples.data());
+    writer->write_buffer(channels.data(), frames);
+    writer->close_file();
+}
+} // namespace
+
+TEST(WavMixerTest, MixesSourcesWithGainAndPan) {
+    write_constant("mix-mono-left.wav", 1, 30000, 0.2f);
+    write_constant("mix-mono-centre.wav", 1, 10000, 0.1f);
+    write_constant("mix-stereo.wav", 2, 20000, 0.05f);
+    const WavFileConfiguration output = {
+            .filename = "mix-output.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT};
+
+    /// Small blocks, so the render spans many rounds
+    WavMixer mixer({.numThreads = 3, .blockFrames = 1000});
+    ASSERT_TRUE(mixer.render({{.filename = "mix-mono-left.wav", .pan = -1.0f},
+                              {.filename = "mix-mono-centre.wav", .gain = 2.0f},
+                              {.filename = "mix-stereo.wav", .pan = 0.5f}},
+                             output));
+
+    auto reader = WavReader::create(output.filename);
+    ASSERT_TRUE(reader.has_value());
+    const auto samples = reader->read<float>(40000);
+    ASSERT_EQ(samples.size(), 2);
+    ASSERT_EQ(samples[0].size(), 30000);
+    const float centre = 0.2f * std::sqrt(0.5f);
+    for (size_t i = 0; i < 30000; ++i) {
+        float left = 0.2f;
+        float right = 0.0f;
+        if (i < 10000) {
+            left += centre;
+            right += centre;
+        }
+        if (i < 20000) {
+            left += 0.025f;
+            right += 0.05f;
+        }
+        ASSERT_NEAR(samples[0][i], left, 1e-6f) << i;
+        ASSERT_NEAR(samples[1][i], right, 1e-6f) << i;
+    }
+    for (const char *filename : {"mix-mono-left.wav", "mix-mono-centre.wav",
+                                  "mix-stereo.wav", "mix-output.wav"}) {
+        std::remove(filename);
+    }
+}
+
+TEST(WavMixerTest, RejectsMismatchedSources) {
+    write_constant("mix-three-channels.wav", 3, 100, 0.0f);
+    WavMixer mixer({.numThreads = 1});
+    EXPECT_FALSE(mixer.render({{.filename = "mix-three-channels.wav"}},
+                              {.filename = "mix-rejected.wav",
+                               .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                               .numChannels = 2,
+                               .bitDepth = WavBitDepth::BIT_DEPTH_32,
+                               .format = WavFormat::FLOAT}));
+    std::remove("mix-three-channels.wav");
+    std::remove("mix-rejected.wav");
+}
@@ -0,0 +1,100 @@
+/// WavProbeTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavProbe.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Probes a list of files and collects the results by index.
+ */
+auto probe_all(const std::vector<std::string> &filenames,
+               const WavProbeOptions &options)
+        -> std::map<size_t, std::optional<WavFileConfiguration>> {
+    std::map<size_t, std::optional<WavFileConfiguration>> results;
+    probe_wav_headers(
+            filenames,
+            [&](const size_t index,
+                const std::optional<WavFileConfiguration> &config) {
+                EXPECT_FALSE(results.contains(index));
+                results[index] = config;
+            },
+            options);
+    return results;
+}
+} // namespace
+
+TEST(WavProbeTest, ProbeManyHeaders) {
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < 40; ++i) {
+        const WavFileConfiguration config = {
+                .filename = "probe-" + std::to_string(i) + ".wav",
+                .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
+                .numChannels = static_cast<uint8_t>(1 + i % 4),
+                .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                .format = WavFormat::PCM,
+        };
+        auto writer = WavWriter::create(config);
+        ASSERT_TRUE(writer.has_value());
+        std::vector<int16_t> samples(i * 10);
+        std::vector<const int16_t *> channels(config.numChannels,
+                                              samples.data());
+        writer->write_buffer(channels.data(), samples.size());
+        writer->close_file();
+        filenames.push_back(config.filename);
+    }
+    /// A header with a large chunk before the data chunk
+    {
+        std::ofstream file("probe-list.wav", std::ios::binary);
+        const uint32_t riffSize = 4 + 24 + 8 + 5000 + 8;
+        const uint32_t fmtSize = 16, listSize = 5000, dataSize = 0;
+        const uint16_t format = 1, channels = 2, blockAlign = 4, bits = 16;
+        const uint32_t rate = 48000, byteRate = rate * blockAlign;
+        file.write("RIFF", 4);
+        file.write(reinterpret_cast<const char *>(&riffSize), 4);
+        file.write("WAVEfmt ", 8);
+        file.write(reinterpret_cast<const char *>(&fmtSize), 4);
+        file.write(reinterpret_cast<const char *>(&format), 2);
+        file.write(reinterpret_cast<const char *>(&channels), 2);
+        file.write(reinterpret_cast<const char *>(&rate), 4);
+        file.write(reinterpret_cast<const char *>(&byteRate), 4);
+        file.write(reinterpret_cast<const char *>(&blockAlign), 2);
+        file.write(reinterpret_cast<const char *>(&bits), 2);
+        file.write("LIST", 4);
+        file.write(reinterpret_cast<const char *>(&listSize), 4);
+        const std::vector<char> padding(listSize, 0);
+        file.write(padding.data(), listSize);
+        file.write("data", 4);
+        file.write(reinterpret_cast<const char *>(&dataSize), 4);
+    }
+    filenames.emplace_back("probe-list.wav");
+    /// Files that are not valid WAV files
+    std::ofstream("probe-text.wav") << "not a wav file";
+    filenames.emplace_back("probe-text.wav");
+    filenames.emplace_back("probe-missing.wav");
+
+    const auto fallback = probe_all(filenames, {.useIoUring = false});
+    const auto batched = probe_all(filenames, {.queueDepth = 8});
+    ASSERT_EQ(filenames.size(), fallback.size());
+    ASSERT_EQ(filenames.size(), batched.size());
+    for (size_t i = 0; i < 40; ++i) {
+        ASSERT_TRUE(batched.at(i).has_value());
+        EXPECT_EQ(filenames[i], batched.at(i)->filename);
+        EXPECT_EQ(1 + i % 4, batched.at(i)->numChannels);
+        EXPECT_EQ(i * 10, batched.at(i)->num_samples());
+        EXPECT_EQ(fallback.at(i)->numChannels, batched.at(i)->numChannels);
+    }
+    ASSERT_TRUE(batched.at(40).has_value());
+    EXPECT_EQ(WavSampleRate::SAMPLE_RATE_48000, batched.at(40)->sampleRate);
+    EXPECT_FALSE(batched.at(41).has_value());
+    EXPECT_FALSE(batched.at(42).has_value());
+    EXPECT_FALSE(fallback.at(41).has_value());
+    for (const auto &filename : filenames) {
+        std::remove(filename.c_str());
+    }
+}
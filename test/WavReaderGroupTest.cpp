@@ -0,0 +1,83 @@
+/// WavReaderGroupTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReaderGroup.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a mono PCM16 file whose samples count up from a base value.
+ */
+auto write_stem(const std::string &filename, const size_t frames,
+                const int16_t base,
+                const WavSampleRate rate = WavSampleRate::SAMPLE_RATE_48000)
+        -> void {
+    std::vector<int16_t> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = static_cast<int16_t>(base + i % 1000);
+    }
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate = rate,
+                                     .numChannels = 1,
+                                     .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                                     .format = WavFormat::PCM});
+    ASSERT_TRUE(writer.has_value());
+    writer->write(frames, samples.data());
+    writer->close_file();
+}
+} // namespace
+
+TEST(WavReaderGroupTest, ReadsFilesInLockstep) {
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < 6; ++i) {
+        filenames.push_back("reader-group-" + std::to_string(i) + ".wav");
+        /// The last file is shorter than the others
+        write_stem(filenames.back(), i == 5 ? 3000 : 5000,
+                   static_cast<int16_t>(i * 1000));
+    }
+    auto group = WavReaderGroup::create(filenames, {.numThreads = 3});
+    ASSERT_TRUE(group.has_value());
+    EXPECT_EQ(group->size(), 6);
+    EXPECT_EQ(group->num_channels(), 6);
+    EXPECT_EQ(group->num_frames(), 5000);
+
+    ASSERT_TRUE(group->seek_frame(2500));
+    const auto block = group->read<int16_t>(1000);
+    ASSERT_EQ(block.size(), 6);
+    for (size_t ch = 0; ch < 6; ++ch) {
+        ASSERT_EQ(block[ch].size(), 1000);
+        for (size_t i = 0; i < 1000; ++i) {
+            const size_t frame = 2500 + i;
+            const int16_t expected =
+                    ch == 5 && frame >= 3000
+                            ? 0
+                            : static_cast<int16_t>(ch * 1000 + frame % 1000);
+            ASSERT_EQ(block[ch][i], expected) << "channel " << ch;
+        }
+    }
+    EXPECT_EQ(group->tell_frame(), 3500);
+
+    /// The end of the longest file ends the group
+    const auto tail = group->read<int16_t>(4000);
+    EXPECT_EQ(tail[0].size(), 1500);
+    EXPECT_EQ(group->tell_frame(), 5000);
+    EXPECT_FALSE(group->seek_frame(5001));
+    for (const auto &filename : filenames) {
+        std::remove(filename.c_str());
+    }
+}
+
+TEST(WavReaderGroupTest, MismatchedSampleRatesFail) {
+    write_stem("reader-group-48k.wav", 100, 0);
+    write_stem("reader-group-44k.wav", 100, 0,
+               WavSampleRate::SAMPLE_RATE_44100);
+    EXPECT_FALSE(WavReaderGroup::create(
+                         {"reader-group-48k.wav", "reader-group-44k.wav"})
+                         .has_value());
+    std::remove("reader-group-48k.wav");
+    std::remove("reader-group-44k.wav");
+}
@@ -0,0 +1,222 @@
+/// WavReaderTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(WavReaderTest, ConcurrentPositionalReads) {
+    const WavFileConfiguration config = {
+            .filename = "pcm32-read-at.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::PCM,
+    };
+    constexpr size_t numFrames = 48000;
+    std::vector<int32_t> left(numFrames);
+    std::vector<int32_t> right(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        left[i] = static_cast<int32_t>(i * 1000);
+        right[i] = -static_cast<int32_t>(i * 1000);
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(numFrames, left.data(), right.data());
+    writer->close_file();
+
+    const auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    /// Each worker reads its own slice through the shared reader
+    constexpr size_t numWorkers = 4;
+    constexpr size_t sliceFrames = numFrames / numWorkers;
+    std::vector<std::vector<int32_t>> slices(numWorkers * 2,
+                                             std::vector<int32_t>(sliceFrames));
+    std::vector<size_t> framesRead(numWorkers);
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < numWorkers; ++w) {
+        workers.emplace_back([&, w] {
+            int32_t *const sampleArrays[] = {slices[w * 2].data(),
+                                             slices[w * 2 + 1].data()};
+            framesRead[w] = reader->read_at(w * sliceFrames, sliceFrames,
+                                            sampleArrays);
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (size_t w = 0; w < numWorkers; ++w) {
+        ASSERT_EQ(sliceFrames, framesRead[w]);
+        for (size_t i = 0; i < sliceFrames; ++i) {
+            EXPECT_EQ(left[w * sliceFrames + i], slices[w * 2][i]);
+            EXPECT_EQ(right[w * sliceFrames + i], slices[w * 2 + 1][i]);
+        }
+    }
+    /// Reads are clamped to the end of the data chunk
+    std::vector<int32_t> tail(100);
+    int32_t *const tailArrays[] = {tail.data(), tail.data()};
+    EXPECT_EQ(10u, reader->read_at(numFrames - 10, tail.size(), tailArrays));
+    EXPECT_EQ(0u, reader->read_at(numFrames, tail.size(), tailArrays));
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavReaderTest, ParallelWholeFileDecode) {
+    const WavFileConfiguration config = {
+            .filename = "pcm24-parallel.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 1,
+            .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
+    };
+    constexpr size_t numFrames = 1000003;
+    std::vector<int32_t> samples(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        samples[i] = static_cast<int32_t>(i % 65536) << 12;
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(numFrames, samples.data());
+    writer->close_file();
+
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    const auto parallel = reader->read_all_parallel<float>(4);
+    const auto sequential = reader->read<float>(numFrames);
+    ASSERT_EQ(1u, parallel.size());
+    ASSERT_EQ(numFrames, parallel[0].size());
+    EXPECT_EQ(sequential[0], parallel[0]);
+
+    /// Decoding into uninitialized caller buffers gives the same samples
+    const auto buffer = std::make_unique_for_overwrite<float[]>(numFrames);
+    float *const sampleArrays[] = {buffer.get()};
+    ASSERT_EQ(numFrames, reader->read_all_parallel_into(sampleArrays, 4));
+    EXPECT_TRUE(std::equal(sequential[0].begin(), sequential[0].end(),
+                           buffer.get()));
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavReaderTest, BlockViewComposesWithRanges) {
+    const WavFileConfiguration config = {
+            .filename = "float32-blocks.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_16000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
+    };
+    constexpr size_t numFrames = 1000;
+    std::vector<float> left(numFrames);
+    std::vector<float> right(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        left[i] = static_cast<float>(i) / numFrames;
+        right[i] = -left[i];
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(numFrames, left.data(), right.data());
+    writer->close_file();
+
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    /// Every block is read into the same buffer
+    size_t frame = 0;
+    const float *buffer = nullptr;
+    for (const auto block : reader->blocks<float>(128)) {
+        ASSERT_EQ(2u, block.size());
+        EXPECT_EQ(std::min<size_t>(128, numFrames - frame), block[0].size());
+        if (buffer == nullptr) {
+            buffer = block[0].data();
+        }
+        EXPECT_EQ(buffer, block[0].data());
+        for (size_t i = 0; i < block[0].size(); ++i) {
+            EXPECT_EQ(left[frame + i], block[0][i]);
+            EXPECT_EQ(right[frame + i], block[1][i]);
+        }
+        frame += block[0].size();
+    }
+    EXPECT_EQ(numFrames, frame);
+
+    /// The view composes with the standard range adaptors
+    auto rewound = WavReader::create(config.filename);
+    ASSERT_TRUE(rewound.has_value());
+    auto lengths = rewound->blocks<int16_t>(300) |
+                   std::views::transform([](const auto block) {
+                       return block[0].size();
+                   }) |
+                   std::views::take(3);
+    std::vector<size_t> blockLengths;
+    for (const size_t length : lengths) {
+        blockLengths.push_back(length);
+    }
+    EXPECT_EQ((std::vector<size_t>{300, 300, 300}), blockLengths);
+
+    /// Composing an lvalue view copies it, and the copy reads into its own
+    /// buffers
+    auto again = WavReader::create(config.filename);
+    ASSERT_TRUE(again.has_value());
+    auto view = again->blocks<float>(100);
+    std::vector<float> firstSamples;
+    for (const auto block : view | std::views::take(3)) {
+        firstSamples.push_back(block[0][0]);
+    }
+    EXPECT_EQ((std::vector<float>{left[0], left[100], left[200]}),
+              firstSamples);
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavReaderTest, CacheHintsAndDirectIoReadSameSamples) {
+    const WavFileConfiguration config = {
+            .filename = "pcm24-direct-io.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 3,
+            .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
+    };
+    constexpr size_t numFrames = 30001;
+    std::vector<std::vector<int32_t>> channels(3,
+                                               std::vector<int32_t>(numFrames));
+    for (size_t ch = 0; ch < 3; ++ch) {
+        for (size_t i = 0; i < numFrames; ++i) {
+            channels[ch][i] = static_cast<int32_t>((ch + 1) * i) << 8;
+        }
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(numFrames, channels[0].data(), channels[1].data(),
+                  channels[2].data());
+    writer->close_file();
+
+    const WavReaderOptions scan = {.sequential = true,
+                                   .readAheadBytes = 1 << 16,
+                                   .dropBehind = true};
+    const WavReaderOptions direct = {.directIo = true};
+    for (const auto &options : {scan, direct}) {
+        auto reader = WavReader::create(config.filename, options);
+        ASSERT_TRUE(reader.has_value());
+        /// Odd block sizes, so reads start and end off alignment
+        std::vector<std::vector<int32_t>> samples(3);
+        while (true) {
+            const auto block = reader->read<int32_t>(777);
+            if (block[0].empty()) {
+                break;
+            }
+            for (size_t ch = 0; ch < 3; ++ch) {
+                samples[ch].insert(samples[ch].end(), block[ch].begin(),
+                                   block[ch].end());
+            }
+        }
+        EXPECT_EQ(samples, channels);
+
+        std::vector<int32_t> a(5), b(5), c(5);
+        std::array<int32_t *, 3> arrays = {a.data(), b.data(), c.data()};
+        ASSERT_EQ(reader->read_at(12345, 5, arrays.data()), 5);
+        EXPECT_EQ(a[0], channels[0][12345]);
+        EXPECT_EQ(c[4], channels[2][12349]);
+    }
+    std::remove(config.filename.c_str());
+}
@@ -0,0 +1,167 @@
+/// WavRealtimeTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavRealtime.h>
+#include <AudioFileTools/WavSharedRing.h>
+#include <AudioFileTools/WavWriter.h>
+#include <AudioFileTools/WavWriterGroup.h>
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#if AUDIO_FILE_TOOLS_RT_CHECKS
+namespace {
+/** Keeps test allocations observable, so they are not optimized away */
+int *volatile g_sink = nullptr;
+
+const WavFileConfiguration kConfig = {
+        .filename = "realtime.wav",
+        .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+        .numChannels = 2,
+        .bitDepth = WavBitDepth::BIT_DEPTH_24,
+        .format = WavFormat::PCM};
+} // namespace
+
+TEST(WavRealtimeTest, TrapsAllocationsOnlyInScope) {
+    wav_realtime_reset_violations();
+    g_sink = new int(1);
+    delete g_sink;
+    EXPECT_EQ(wav_realtime_violations().total(), 0u);
+    {
+        const WavRealtimeScope scope;
+        EXPECT_TRUE(wav_in_realtime_scope());
+        g_sink = new int(2);
+        delete g_sink;
+    }
+    EXPECT_FALSE(wav_in_realtime_scope());
+    const WavRealtimeViolations violations = wav_realtime_violations();
+    EXPECT_EQ(violations.allocations, 1u);
+    EXPECT_EQ(violations.deallocations, 1u);
+    EXPECT_EQ(violations.blockingCalls, 0u);
+    wav_realtime_reset_violations();
+    EXPECT_EQ(wav_realtime_violations().total(), 0u);
+}
+
+TEST(WavRealtimeTest, RingProducerWriteIsRealtimeSafe) {
+    const std::string name =
+            "/wav_realtime_test_" + std::to_string(::getpid());
+    auto producer = WavRingProducer::create(name, kConfig, 1024);
+    ASSERT_TRUE(producer.has_value());
+    const std::vector<float> left(256, 0.25f);
+    const std::vector<float> right(256, -0.25f);
+    wav_realtime_reset_violations();
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(producer->write(left.size(), left.data(), right.data()),
+                  256u);
+    }
+    EXPECT_EQ(wav_realtime_violations().total(), 0u);
+}
+
+TEST(WavRealtimeTest, WriterStopsAllocatingAfterTheFirstBlock) {
+    auto writer = WavWriter::create(kConfig);
+    ASSERT_TRUE(writer.has_value());
+    const std::vector<float> left(256, 0.25f);
+    const std::vector<float> right(256, -0.25f);
+    writer->write(left.size(), left.data(), right.data());
+    wav_realtime_reset_violations();
+    for (int i = 0; i < 4; ++i) {
+        writer->write(left.size(), left.data(), right.data());
+    }
+    /// The file stream write is still a system call
+    const WavRealtimeViolations violations = wav_realtime_violations();
+    EXPECT_EQ(violations.allocations, 0u);
+    EXPECT_EQ(violations.deallocations, 0u);
+    EXPECT_EQ(violations.blockingCalls, 4u);
+    EXPECT_STREQ(violations.lastCall, "std::ofstream::write");
+    writer->close_file();
+    std::filesystem::remove(kConfig.filename);
+}
+
+TEST(WavRealtimeTest, WriterGroupOnlyBlocksWhenFlushing) {
+    const std::vector<WavFileConfiguration> configs = {
+            {.filename = "realtime-group.wav",
+             .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+             .numChannels = 1,
+             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+             .format = WavFormat::PCM}};
+    /// Two 512-byte buffers of 256 frames, so blocks that stop short of
+    /// filling one do not block, and every 256-frame block flushes once
+    auto group = WavWriterGroup::create(
+            configs, {.numThreads = 1, .maxBufferedBytes = 1024});
+    ASSERT_TRUE(group.has_value());
+    const std::vector<int16_t> samples(256, 100);
+    const std::array<const int16_t *, 1> arrays = {samples.data()};
+    group->write_buffer(arrays.data(), 64);
+    wav_realtime_reset_violations();
+    group->write_buffer(arrays.data(), 64);
+    EXPECT_EQ(wav_realtime_violations().total(), 0u);
+    for (int i = 0; i < 4; ++i) {
+        group->write_buffer(arrays.data(), samples.size());
+    }
+    /// Each flush waits on the track's mutex and queues a task on the pool
+    const WavRealtimeViolations violations = wav_realtime_violations();
+    EXPECT_EQ(violations.allocations, 0u);
+    EXPECT_EQ(violations.deallocations, 0u);
+    EXPECT_EQ(violations.blockingCalls, 8u);
+    EXPECT_STREQ(violations.lastCall, "WavThreadPool::submit");
+    group->close();
+    std::filesystem::remove(configs[0].filename);
+}
+
+TEST(WavRealtimeTest, ReaderStopsAllocatingAfterTheFirstBlock) {
+    {
+        auto writer = WavWriter::create(kConfig);
+        ASSERT_TRUE(writer.has_value());
+        const std::vector<float> samples(1024, 0.5f);
+        writer->write(samples.size(), samples.data(), samples.data());
+    }
+    auto reader = WavReader::create(kConfig.filename);
+    ASSERT_TRUE(reader.has_value());
+    std::vector<float> left(256);
+    std::vector<float> right(256);
+    const std::array<float *, 2> arrays = {left.data(), right.data()};
+    EXPECT_EQ(reader->read_into(256, arrays.data()), 256u);
+    wav_realtime_reset_violations();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(reader->read_into(256, arrays.data()), 256u);
+    }
+    const WavRealtimeViolations violations = wav_realtime_violations();
+    EXPECT_EQ(violations.allocations, 0u);
+    EXPECT_EQ(violations.deallocations, 0u);
+    EXPECT_EQ(violations.blockingCalls, 3u);
+    EXPECT_STREQ(violations.lastCall, "pread");
+    std::filesystem::remove(kConfig.filename);
+}
+
+TEST(WavRealtimeTest, ReaderReportsCacheHints) {
+    {
+        auto writer = WavWriter::create(kConfig);
+        ASSERT_TRUE(writer.has_value());
+        const std::vector<float> samples(1024, 0.5f);
+        writer->write(samples.size(), samples.data(), samples.data());
+    }
+    auto reader = WavReader::create(
+            kConfig.filename, {.readAheadBytes = 4096, .dropBehind = true});
+    ASSERT_TRUE(reader.has_value());
+    std::vector<float> left(256);
+    std::vector<float> right(256);
+    const std::array<float *, 2> arrays = {left.data(), right.data()};
+    EXPECT_EQ(reader->read_into(256, arrays.data()), 256u);
+    wav_realtime_reset_violations();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(reader->read_into(256, arrays.data()), 256u);
+    }
+    /// Each block is a pread plus a read-ahead and a drop-behind hint
+    const WavRealtimeViolations violations = wav_realtime_violations();
+    EXPECT_EQ(violations.allocations, 0u);
+    EXPECT_EQ(violations.deallocations, 0u);
+    EXPECT_EQ(violations.blockingCalls, 9u);
+    EXPECT_STREQ(violations.lastCall, "posix_fadvise");
+    std::filesystem::remove(kConfig.filename);
+}
+#endif
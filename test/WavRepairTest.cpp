@@ -0,0 +1,152 @@
+/// WavRepairTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavRepair.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST(WavRepairTest, RepairUnfinalizedHeaders) {
+    std::vector<std::string> filenames;
+    for (size_t i = 0; i < 8; ++i) {
+        const WavFileConfiguration config = {
+                .filename = "crashed-" + std::to_string(i) + ".wav",
+                .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                .numChannels = 2,
+                .bitDepth = WavBitDepth::BIT_DEPTH_24,
+                .format = WavFormat::PCM,
+        };
+        /// Write a header with placeholder sizes followed by audio data and
+        /// a partial trailing frame, as left behind by a crashed writer
+        auto writer = WavWriter::create(config);
+        ASSERT_TRUE(writer.has_value());
+        writer->close_file();
+        std::ofstream file(config.filename,
+                           std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t zero = 0;
+        file.seekp(4, std::ios::beg);
+        file.write(reinterpret_cast<const char *>(&zero), 4);
+        file.seekp(0, std::ios::end);
+        const std::vector<char> payload(6 * (100 + i) + 4, 0);
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        file.close();
+        filenames.push_back(config.filename);
+    }
+    filenames.emplace_back("does-not-exist.wav");
+
+    const auto results = repair_wav_headers(filenames, 4);
+    ASSERT_EQ(filenames.size(), results.size());
+    EXPECT_FALSE(results.back().has_value());
+    for (size_t i = 0; i < 8; ++i) {
+        ASSERT_TRUE(results[i].has_value());
+        EXPECT_EQ(100 + i, results[i]->num_samples());
+        auto reader = WavReader::create(filenames[i]);
+        ASSERT_TRUE(reader.has_value());
+        EXPECT_EQ(100 + i, reader->get_configuration().num_samples());
+        reader->close_file();
+        /// Repairing again must leave the finalized header alone
+        const auto repeated = repair_wav_header(filenames[i]);
+        ASSERT_TRUE(repeated.has_value());
+        EXPECT_EQ(100 + i, repeated->num_samples());
+        std::remove(filenames[i].c_str());
+    }
+}
+
+TEST(WavRepairTest, RepairCrashedAppend) {
+    const WavFileConfiguration config = {
+            .filename = "crashed-append.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    std::vector<int16_t> left(1000);
+    std::vector<int16_t> right(1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        left[i] = static_cast<int16_t>(i);
+        right[i] = static_cast<int16_t>(-static_cast<int>(i));
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(600, left.data(), right.data());
+    writer->close_file();
+    /// Keep the finalized header of the first recording
+    std::vector<char> header(44);
+    {
+        std::ifstream file(config.filename, std::ios::binary);
+        file.read(header.data(), static_cast<std::streamsize>(header.size()));
+        ASSERT_TRUE(file);
+    }
+    auto appender = WavWriter::open_append(config);
+    ASSERT_TRUE(appender.has_value());
+    appender->write(400, left.data() + 600, right.data() + 600);
+    appender->close_file();
+    /// Restore the old sizes, as left behind by an appender that crashed
+    /// before it could update the header
+    {
+        std::ofstream file(config.filename,
+                           std::ios::binary | std::ios::in | std::ios::out);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+    auto stale = WavReader::create(config.filename);
+    ASSERT_TRUE(stale.has_value());
+    EXPECT_EQ(600u, stale->get_configuration().num_samples());
+    stale->close_file();
+
+    const auto repaired = repair_wav_header(config.filename);
+    ASSERT_TRUE(repaired.has_value());
+    EXPECT_EQ(1000u, repaired->num_samples());
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(1000u, reader->get_configuration().num_samples());
+    const auto samples = reader->read<int16_t>(1000);
+    ASSERT_EQ(1000u, samples[0].size());
+    EXPECT_EQ(left[999], samples[0][999]);
+    EXPECT_EQ(right[999], samples[1][999]);
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavRepairTest, RepairPrintablePayload) {
+    const WavFileConfiguration config = {
+            .filename = "crashed-printable.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 1,
+            .bitDepth = WavBitDepth::BIT_DEPTH_8,
+            .format = WavFormat::PCM,
+    };
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->close_file();
+    /// Audio bytes in the printable range with a small value in the four
+    /// bytes after them, which would pass for a chunk header that fits in
+    /// the file if the payload were probed
+    {
+        std::ofstream file(config.filename,
+                           std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t zero = 0;
+        file.seekp(4, std::ios::beg);
+        file.write(reinterpret_cast<const char *>(&zero), 4);
+        file.seekp(0, std::ios::end);
+        std::vector<char> payload(1000);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<char>(0x70 + i % 15);
+        }
+        payload[4] = 0x10;
+        payload[5] = payload[6] = payload[7] = 0;
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+
+    const auto repaired = repair_wav_header(config.filename);
+    ASSERT_TRUE(repaired.has_value());
+    EXPECT_EQ(1000u, repaired->num_samples());
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(1000u, reader->get_configuration().num_samples());
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
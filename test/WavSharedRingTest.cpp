@@ -0,0 +1,101 @@
+/// WavSharedRingTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavSharedRing.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief Builds a shared memory name unique to this process.
+ */
+auto ring_name(const std::string &suffix) -> std::string {
+    return "/wav_ring_test_" + std::to_string(::getpid()) + "_" + suffix;
+}
+} // namespace
+
+TEST(WavSharedRingTest, DrainsIntoWriter) {
+    const std::string name = ring_name("drain");
+    const WavFileConfiguration config = {
+            .filename = "ring-output.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM};
+    constexpr size_t totalFrames = 10000;
+    constexpr size_t blockFrames = 64;
+    std::vector<int16_t> left(totalFrames);
+    std::vector<int16_t> right(totalFrames);
+    for (size_t i = 0; i < totalFrames; ++i) {
+        left[i] = static_cast<int16_t>(i);
+        right[i] = static_cast<int16_t>(-static_cast<int>(i));
+    }
+
+    /// A small ring, so the producer wraps around and waits on the consumer
+    auto producer = WavRingProducer::create(name, config, 100);
+    ASSERT_TRUE(producer.has_value());
+    auto consumer = WavRingConsumer::open(name);
+    ASSERT_TRUE(consumer.has_value());
+    const auto ringConfig = consumer->get_configuration();
+    EXPECT_EQ(ringConfig.numChannels, 2);
+    EXPECT_EQ(ringConfig.sampleRate, WavSampleRate::SAMPLE_RATE_48000);
+    EXPECT_EQ(ringConfig.bitDepth, WavBitDepth::BIT_DEPTH_16);
+    EXPECT_EQ(ringConfig.format, WavFormat::PCM);
+
+    std::thread capture([&] {
+        size_t frame = 0;
+        while (frame < totalFrames) {
+            const size_t count = std::min(blockFrames, totalFrames - frame);
+            frame += producer->write(count, left.data() + frame,
+                                     right.data() + frame);
+        }
+        producer->finish();
+    });
+
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    size_t drained = 0;
+    while (!consumer->is_finished()) {
+        drained += consumer->drain_to(*writer);
+    }
+    capture.join();
+    writer->close_file();
+    EXPECT_EQ(drained, totalFrames);
+
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    const auto samples = reader->read<int16_t>(totalFrames);
+    ASSERT_EQ(samples.size(), 2);
+    EXPECT_EQ(samples[0], left);
+    EXPECT_EQ(samples[1], right);
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavSharedRingTest, WriteStopsWhenFull) {
+    const std::string name = ring_name("full");
+    const WavFileConfiguration config = {
+            .filename = "",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_16000,
+            .numChannels = 1,
+            .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT};
+    auto producer = WavRingProducer::create(name, config, 16);
+    ASSERT_TRUE(producer.has_value());
+    /// The same name cannot be created twice
+    EXPECT_FALSE(WavRingProducer::create(name, config, 16).has_value());
+
+    const std::vector<float> samples(32, 0.5f);
+    EXPECT_EQ(producer->write(32, samples.data()), 16);
+    EXPECT_EQ(producer->write(1, samples.data()), 0);
+}
+
+TEST(WavSharedRingTest, OpenMissingRingFails) {
+    EXPECT_FALSE(WavRingConsumer::open(ring_name("missing")).has_value());
+}
@@ -0,0 +1,137 @@
+/// WavStatsTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavStats.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a stereo 16-bit file from float samples in blocks.
+ * @details The writer's statistics are stored in stats, if it is not null.
+ */
+auto write_blocks(const std::string &filename, const WavWriterOptions options,
+                  const size_t blocks, const size_t frames,
+                  WavIoStats *stats = nullptr) -> void {
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate =
+                                             WavSampleRate::SAMPLE_RATE_48000,
+                                     .numChannels = 2,
+                                     .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                                     .format = WavFormat::PCM},
+                                    options);
+    ASSERT_TRUE(writer.has_value());
+    const std::vector<float> left(frames, 0.25f);
+    const std::vector<float> right(frames, -0.25f);
+    for (size_t i = 0; i < blocks; ++i) {
+        writer->write(frames, left.data(), right.data());
+    }
+    writer->close_file();
+    if (stats != nullptr) {
+        *stats = writer->get_stats();
+    }
+}
+} // namespace
+
+TEST(WavStatsTest, DisabledByDefault) {
+    const std::string filename = "stats-disabled.wav";
+    WavIoStats stats;
+    write_blocks(filename, {}, 4, 256, &stats);
+    EXPECT_EQ(stats.bytes, 0u);
+    EXPECT_EQ(stats.ioCalls, 0u);
+
+    auto reader = WavReader::create(filename);
+    ASSERT_TRUE(reader.has_value());
+    reader->read<float>(1024);
+    EXPECT_EQ(reader->get_stats().frames, 0u);
+    std::filesystem::remove(filename);
+}
+
+#if AUDIO_FILE_TOOLS_STATS
+TEST(WavStatsTest, WriterCountsBlocks) {
+    const std::string filename = "stats-writer.wav";
+    WavIoStats stats;
+    write_blocks(filename, {.collectStats = true}, 4, 256, &stats);
+    EXPECT_EQ(stats.frames, 1024u);
+    EXPECT_EQ(stats.bytes, 1024u * 4);
+    EXPECT_EQ(stats.ioCalls, 4u);
+    /// The encode buffer is kept, so only the first block allocates
+    EXPECT_EQ(stats.allocations, 1u);
+    EXPECT_EQ(stats.seeks, 2u);
+    EXPECT_GT(stats.conversionNanoseconds, 0u);
+    EXPECT_EQ(stats.interleaveNanoseconds, 0u);
+    std::filesystem::remove(filename);
+}
+
+TEST(WavStatsTest, DirectIoReaderReusesAlignedBuffer) {
+    const std::string filename = "stats-reader-direct.wav";
+    write_blocks(filename, {}, 4, 256);
+    auto reader = WavReader::create(filename, {.directIo = true,
+                                               .collectStats = true});
+    ASSERT_TRUE(reader.has_value());
+    if (!reader->is_direct_io()) {
+        reader->close_file();
+        std::filesystem::remove(filename);
+        GTEST_SKIP() << "O_DIRECT is not supported here";
+    }
+
+    std::vector<int16_t> left(256);
+    std::vector<int16_t> right(256);
+    const std::array<int16_t *, 2> arrays = {left.data(), right.data()};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(reader->read_into(256, arrays.data()), 256u);
+    }
+    /// Only the first read allocates the raw and the aligned buffer
+    EXPECT_EQ(reader->get_stats().allocations, 2u);
+    reader->close_file();
+    std::filesystem::remove(filename);
+}
+
+TEST(WavStatsTest, ReaderSplitsConversionFromInterleaving) {
+    const std::string filename = "stats-reader.wav";
+    write_blocks(filename, {}, 4, 256);
+    auto reader = WavReader::create(filename, {.collectStats = true});
+    ASSERT_TRUE(reader.has_value());
+
+    std::vector<int16_t> left(512);
+    std::vector<int16_t> right(512);
+    const std::array<int16_t *, 2> arrays = {left.data(), right.data()};
+    EXPECT_EQ(reader->read_into(512, arrays.data()), 512u);
+    EXPECT_EQ(reader->read_into(512, arrays.data()), 512u);
+    WavIoStats stats = reader->get_stats();
+    EXPECT_EQ(stats.frames, 1024u);
+    EXPECT_EQ(stats.bytes, 1024u * 4);
+    EXPECT_EQ(stats.ioCalls, 2u);
+    /// The raw buffer is kept, so only the first read allocates
+    EXPECT_EQ(stats.allocations, 1u);
+    EXPECT_GT(stats.interleaveNanoseconds, 0u);
+    EXPECT_EQ(stats.conversionNanoseconds, 0u);
+
+    reader->reset_stats();
+    ASSERT_TRUE(reader->seek_frame(0));
+    reader->read<float>(1024);
+    stats = reader->get_stats();
+    EXPECT_EQ(stats.seeks, 1u);
+    EXPECT_EQ(stats.frames, 1024u);
+    EXPECT_GT(stats.conversionNanoseconds, 0u);
+    EXPECT_EQ(stats.interleaveNanoseconds, 0u);
+    std::filesystem::remove(filename);
+}
+
+TEST(WavStatsTest, SharedReaderCountsConcurrentReads) {
+    const std::string filename = "stats-shared.wav";
+    write_blocks(filename, {}, 8, 512);
+    const auto reader = WavReader::create(filename, {.collectStats = true});
+    ASSERT_TRUE(reader.has_value());
+    const auto samples = reader->read_all_parallel<float>(4);
+    ASSERT_EQ(samples[0].size(), 4096u);
+    EXPECT_EQ(reader->get_stats().frames, 4096u);
+    EXPECT_EQ(reader->get_stats().bytes, 4096u * 4);
+    std::filesystem::remove(filename);
+}
+#endif
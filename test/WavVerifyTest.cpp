@@ -0,0 +1,143 @@
+/// WavVerifyTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavVerify.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Writes a mono PCM8 file with a given number of frames.
+ */
+auto write_pcm8(const std::string &filename, const size_t frames,
+                const bool storeHash = false) -> void {
+    const std::vector<uint8_t> samples(frames, 100);
+    auto writer = WavWriter::create({.filename = filename,
+                                     .sampleRate =
+                                             WavSampleRate::SAMPLE_RATE_8000,
+                                     .numChannels = 1,
+                                     .bitDepth = WavBitDepth::BIT_DEPTH_8,
+                                     .format = WavFormat::PCM},
+                                    {.storeHash = storeHash});
+    ASSERT_TRUE(writer.has_value());
+    writer->write(frames, samples.data());
+    writer->close_file();
+}
+
+/**
+ * @brief Overwrites bytes of a file at a given offset.
+ */
+auto patch(const std::string &filename, const std::streamoff offset,
+           const std::string &bytes) -> void {
+    std::fstream file(filename, std::ios::binary | std::ios::in |
+                                        std::ios::out);
+    file.seekp(offset);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief Checks whether a report lists an issue.
+ */
+auto has_issue(const WavVerifyReport &report, const WavVerifyIssue issue)
+        -> bool {
+    return std::ranges::find(report.issues, issue) != report.issues.end();
+}
+} // namespace
+
+TEST(WavVerifyTest, DetectsStructuralProblems) {
+    write_pcm8("verify-valid.wav", 1000);
+    write_pcm8("verify-truncated.wav", 1000);
+    std::filesystem::resize_file("verify-truncated.wav", 44 + 500);
+    write_pcm8("verify-unsupported.wav", 1000);
+    patch("verify-unsupported.wav", 20, std::string("\x02\x00", 2));
+    write_pcm8("verify-odd.wav", 999);
+    write_pcm8("verify-padding.wav", 999);
+    {
+        /// An odd data chunk followed directly by another chunk
+        std::ofstream file("verify-padding.wav",
+                           std::ios::binary | std::ios::app);
+        file.write("LIST\x00\x00\x00\x00", 8);
+    }
+    patch("verify-padding.wav", 4, std::string("\xFF\x03\x00\x00", 4));
+
+    const auto reports = verify_wav_files(
+            {"verify-valid.wav", "verify-truncated.wav",
+             "verify-unsupported.wav", "verify-padding.wav",
+             "verify-missing.wav", "verify-odd.wav"},
+            {.numThreads = 2});
+    ASSERT_EQ(reports.size(), 6);
+    EXPECT_TRUE(reports[0].valid());
+    ASSERT_TRUE(reports[0].config.has_value());
+    EXPECT_EQ(reports[0].config->num_samples(), 1000);
+    EXPECT_TRUE(has_issue(reports[1], WavVerifyIssue::TRUNCATED_DATA));
+    EXPECT_TRUE(has_issue(reports[1], WavVerifyIssue::RIFF_SIZE_MISMATCH));
+    EXPECT_TRUE(has_issue(reports[2], WavVerifyIssue::UNSUPPORTED_FORMAT));
+    EXPECT_TRUE(has_issue(reports[3], WavVerifyIssue::MISSING_PADDING));
+    EXPECT_TRUE(has_issue(reports[4], WavVerifyIssue::OPEN_FAILED));
+    /// An odd data chunk that ends the file needs no pad byte
+    EXPECT_TRUE(reports[5].valid());
+
+    std::ostringstream json;
+    write_wav_verify_json(json, reports);
+    EXPECT_NE(json.str().find("\"truncated_data\""), std::string::npos);
+    EXPECT_NE(json.str().find("\"file\": \"verify-valid.wav\", "
+                              "\"valid\": true"),
+              std::string::npos);
+    for (const char *filename : {"verify-valid.wav", "verify-truncated.wav",
+                                  "verify-unsupported.wav",
+                                  "verify-padding.wav", "verify-odd.wav"}) {
+        std::filesystem::remove(filename);
+    }
+}
+
+TEST(WavVerifyTest, ChecksStoredHash) {
+    write_pcm8("verify-hash.wav", 1000, true);
+    auto report = verify_wav_file("verify-hash.wav", {.checkHash = true});
+    EXPECT_TRUE(report.valid());
+    EXPECT_TRUE(report.hashChecked);
+
+    /// Corrupt one sample
+    patch("verify-hash.wav", 44 + 10, "\x01");
+    report = verify_wav_file("verify-hash.wav", {.checkHash = true});
+    EXPECT_TRUE(has_issue(report, WavVerifyIssue::HASH_MISMATCH));
+    /// Without the hash check only metadata is read
+    EXPECT_TRUE(verify_wav_file("verify-hash.wav").valid());
+    std::filesystem::remove("verify-hash.wav");
+}
+
+TEST(WavVerifyTest, StreamsReportsFromAList) {
+    write_pcm8("verify-list-0.wav", 1000);
+    write_pcm8("verify-list-1.wav", 500);
+    std::istringstream list(
+            "verify-list-0.wav\n\nverify-list-1.wav\nverify-list-missing.wav\n");
+    std::vector<WavVerifyReport> reports(3);
+    size_t calls = 0;
+    const size_t count = verify_wav_files(
+            list,
+            [&](const size_t index, const WavVerifyReport &report) {
+                ASSERT_LT(index, reports.size());
+                reports[index] = report;
+                ++calls;
+            },
+            {.numThreads = 2});
+    /// The empty line is skipped
+    EXPECT_EQ(count, 3);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(reports[0].filename, "verify-list-0.wav");
+    EXPECT_TRUE(reports[0].valid());
+    EXPECT_EQ(reports[1].filename, "verify-list-1.wav");
+    EXPECT_TRUE(reports[1].valid());
+    EXPECT_TRUE(has_issue(reports[2], WavVerifyIssue::OPEN_FAILED));
+
+    std::ostringstream json;
+    write_wav_verify_json(json, reports[0]);
+    EXPECT_EQ(json.str().front(), '{');
+    EXPECT_EQ(json.str().back(), '}');
+    std::filesystem::remove("verify-list-0.wav");
+    std::filesystem::remove("verify-list-1.wav");
+}
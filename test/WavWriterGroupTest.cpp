@@ -0,0 +1,98 @@
+/// WavWriterGroupTest.cpp
+
+#include <gtest/gtest.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavWriterGroup.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+TEST(WavWriterGroupTest, RoutesChannelsToFiles) {
+    /// Eight mono tracks followed by one stereo track
+    std::vector<WavFileConfiguration> configs;
+    for (size_t i = 0; i < 8; ++i) {
+        configs.push_back({.filename = "group-track-" + std::to_string(i) +
+                                       ".wav",
+                           .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                           .numChannels = 1,
+                           .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                           .format = WavFormat::PCM});
+    }
+    configs.push_back({.filename = "group-track-stereo.wav",
+                       .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                       .numChannels = 2,
+                       .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                       .format = WavFormat::PCM});
+
+    /// A small budget, so every file is flushed many times
+    auto group = WavWriterGroup::create(
+            configs, {.numThreads = 2, .maxBufferedBytes = 16 << 10});
+    ASSERT_TRUE(group.has_value());
+    EXPECT_EQ(group->size(), 9);
+    ASSERT_EQ(group->num_channels(), 10);
+
+    constexpr size_t totalFrames = 20000;
+    constexpr size_t blockFrames = 128;
+    std::vector<std::vector<int16_t>> expected(10,
+                                               std::vector<int16_t>(totalFrames));
+    for (size_t ch = 0; ch < 10; ++ch) {
+        for (size_t i = 0; i < totalFrames; ++i) {
+            expected[ch][i] = static_cast<int16_t>(ch * 1000 + i % 1000);
+        }
+    }
+    for (size_t frame = 0; frame < totalFrames; frame += blockFrames) {
+        std::vector<const int16_t *> block(10);
+        for (size_t ch = 0; ch < 10; ++ch) {
+            block[ch] = expected[ch].data() + frame;
+        }
+        group->write_buffer(block.data(),
+                            std::min(blockFrames, totalFrames - frame));
+    }
+    group->close();
+
+    for (size_t i = 0; i < 8; ++i) {
+        auto reader = WavReader::create(configs[i].filename);
+        ASSERT_TRUE(reader.has_value());
+        const auto samples = reader->read<int16_t>(totalFrames);
+        ASSERT_EQ(samples.size(), 1);
+        EXPECT_EQ(samples[0], expected[i]);
+    }
+    auto reader = WavReader::create(configs[8].filename);
+    ASSERT_TRUE(reader.has_value());
+    const auto samples = reader->read<int16_t>(totalFrames);
+    ASSERT_EQ(samples.size(), 2);
+    EXPECT_EQ(samples[0], expected[8]);
+    EXPECT_EQ(samples[1], expected[9]);
+    for (const auto &config : configs) {
+        std::remove(config.filename.c_str());
+    }
+}
+
+TEST(WavWriterGroupTest, UnwritableFileFails) {
+    const std::vector<WavFileConfiguration> configs = {
+            {.filename = "missing-directory/group-invalid.wav",
+             .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+             .numChannels = 1,
+             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+             .format = WavFormat::PCM}};
+    EXPECT_FALSE(WavWriterGroup::create(configs).has_value());
+    EXPECT_FALSE(WavWriterGroup::create({}).has_value());
+}
+
+TEST(WavWriterGroupTest, FailedCreateRemovesEarlierFiles) {
+    std::vector<WavFileConfiguration> configs;
+    for (const char *filename :
+         {"group-cleanup-0.wav", "group-cleanup-1.wav",
+          "missing-directory/group-cleanup-2.wav"}) {
+        configs.push_back({.filename = filename,
+                           .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+                           .numChannels = 1,
+                           .bitDepth = WavBitDepth::BIT_DEPTH_16,
+                           .format = WavFormat::PCM});
+    }
+    EXPECT_FALSE(WavWriterGroup::create(configs).has_value());
+    EXPECT_FALSE(std::filesystem::exists(configs[0].filename));
+    EXPECT_FALSE(std::filesystem::exists(configs[1].filename));
+}
@@ -4,16 +4,21 @@
 #include <AudioFileTools/WavReader.h>
 #include <AudioFileTools/WavWriter.h>
 
+#include <cmath>
+#include <csignal>
 #include <fstream>
+#include <string>
 #include <vector>
 
+#include <sys/resource.h>
+
 TEST(WavWriterTest, CreateValidWavWriter) {
     const WavFileConfiguration config = {
             .filename = "test.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::FLOAT,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -23,7 +28,8 @@ TEST(WavWriterTest, CreateValidWavWriter) {
     /// Try to read it back
     auto reader = WavReader::create(config.filename);
     ASSERT_TRUE(reader.has_value());
-    auto [filename, sampleRate, numChannels, bitDepth, format] = reader->get_configuration();
+    auto [filename, sampleRate, numChannels, bitDepth, format, blockAlign,
+          dataChunkSize] = reader->get_configuration();
     EXPECT_EQ(config.filename, filename);
     EXPECT_EQ(config.sampleRate, sampleRate);
     EXPECT_EQ(config.numChannels, numChannels);
@@ -38,8 +44,8 @@ TEST(WavWriterTest, WriteFloatBufferToFloat32) {
             .filename = "float32-in_float32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::FLOAT,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -55,7 +61,8 @@ TEST(WavWriterTest, WriteFloatBufferToFloat32) {
     /// Now read it back
     auto reader = WavReader::create(config.filename);
     ASSERT_TRUE(reader.has_value());
-    auto [filename, sampleRate, numChannels, bitDepth, format] = reader->get_configuration();
+    auto [filename, sampleRate, numChannels, bitDepth, format, blockAlign,
+          dataChunkSize] = reader->get_configuration();
     EXPECT_EQ(config.filename, filename);
     EXPECT_EQ(config.sampleRate, sampleRate);
     EXPECT_EQ(config.numChannels, numChannels);
@@ -74,8 +81,8 @@ TEST(WavWriterTest, WriteFloatBufferToPCM8) {
             .filename = "float32-in_pcm8-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_8,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -110,8 +117,8 @@ TEST(WavWriterTest, WriteFloatBufferToPCM16) {
             .filename = "float32-in_pcm16-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -146,8 +153,8 @@ TEST(WavWriterTest, WriteFloatBufferToPCM24) {
             .filename = "float32-in_pcm24-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -161,20 +168,20 @@ TEST(WavWriterTest, WriteFloatBufferToPCM24) {
     writer->write(samples.size(), samples.data());
     writer->close_file();
     /// Now read it back
-    // auto reader = WavReader::create(config.filename);
-    // ASSERT_TRUE(reader.has_value());
-    // WavFileConfiguration readConfig = reader->get_configuration();
-    // EXPECT_EQ(config.filename, readConfig.filename);
-    // EXPECT_EQ(config.sampleRate, readConfig.sampleRate);
-    // EXPECT_EQ(config.numChannels, readConfig.numChannels);
-    // EXPECT_EQ(config.format, readConfig.format);
-    // EXPECT_EQ(config.bitDepth, readConfig.bitDepth);
-    // auto readSamples = reader->read<float>(44100);
-    // for (size_t i = 0; i < 44100; ++i) {
-    //     EXPECT_NEAR(samples[i], readSamples[0][i], 0.01);
-    // }
-    // reader->close_file();
-    // std::remove(config.filename.c_str());
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    WavFileConfiguration readConfig = reader->get_configuration();
+    EXPECT_EQ(config.filename, readConfig.filename);
+    EXPECT_EQ(config.sampleRate, readConfig.sampleRate);
+    EXPECT_EQ(config.numChannels, readConfig.numChannels);
+    EXPECT_EQ(config.format, readConfig.format);
+    EXPECT_EQ(config.bitDepth, readConfig.bitDepth);
+    auto readSamples = reader->read<float>(44100);
+    for (size_t i = 0; i < 44100; ++i) {
+        EXPECT_NEAR(samples[i], readSamples[0][i], 0.01);
+    }
+    reader->close_file();
+    std::remove(config.filename.c_str());
 }
 
 TEST(WavWriterTest, WriteFloatBufferToPCM32) {
@@ -182,8 +189,8 @@ TEST(WavWriterTest, WriteFloatBufferToPCM32) {
             .filename = "float32-in_pcm32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -218,8 +225,8 @@ TEST(WavWriterTest, WritePCM8BufferToFloat32) {
             .filename = "pcm8-in_float32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::FLOAT,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -256,8 +263,8 @@ TEST(WavWriterTest, WritePCM8BufferToPCM8) {
             .filename = "pcm8-in_pcm8-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_8,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -280,8 +287,8 @@ TEST(WavWriterTest, WritePCM8BufferToPCM16) {
             .filename = "pcm8-in_pcm18-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -303,8 +310,8 @@ TEST(WavWriterTest, WritePCM8BufferToPCM24) {
             .filename = "pcm8-in_pcm24-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -326,8 +333,8 @@ TEST(WavWriterTest, WritePCM8BufferToPCM32) {
             .filename = "pcm8-in_pcm32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -349,8 +356,8 @@ TEST(WavWriterTest, WritePCM16BufferToFloat32) {
             .filename = "pcm16-in_float32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::FLOAT,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -370,8 +377,8 @@ TEST(WavWriterTest, WritePCM16BufferToPCM8) {
             .filename = "pcm16-in_pcm8-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_8,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -391,8 +398,8 @@ TEST(WavWriterTest, WritePCM16BufferToPCM16) {
             .filename = "pcm16-in_pcm16-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -412,8 +419,8 @@ TEST(WavWriterTest, WritePCM16BufferToPCM24) {
             .filename = "pcm16-in_pcm24-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -433,8 +440,8 @@ TEST(WavWriterTest, WritePCM16BufferToPCM32) {
             .filename = "pcm16-in_pcm32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -454,8 +461,8 @@ TEST(WavWriterTest, WritePCM32BufferToFloat32) {
             .filename = "pcm32-in_float32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::FLOAT,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::FLOAT,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -475,8 +482,8 @@ TEST(WavWriterTest, WritePCM32BufferToPCM8) {
             .filename = "pcm32-in_pcm8-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_8,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -496,8 +503,8 @@ TEST(WavWriterTest, WritePCM32BufferToPCM16) {
             .filename = "pcm32-in_pcm16-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -517,8 +524,8 @@ TEST(WavWriterTest, WritePCM32BufferToPCM24) {
             .filename = "pcm32-in_pcm24-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -538,8 +545,8 @@ TEST(WavWriterTest, WritePCM32BufferToPCM32) {
             .filename = "pcm32-in_pcm32-out.wav",
             .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
             .numChannels = 1,
-            .format = WavFormat::PCM,
             .bitDepth = WavBitDepth::BIT_DEPTH_32,
+            .format = WavFormat::PCM,
     };
     auto writer = WavWriter::create(config);
     ASSERT_TRUE(writer.has_value());
@@ -553,3 +560,156 @@ TEST(WavWriterTest, WritePCM32BufferToPCM32) {
     writer->write(samples.size(), samples.data());
     writer->close_file();
 }
+
+TEST(WavWriterTest, AppendToExistingFile) {
+    const WavFileConfiguration config = {
+            .filename = "pcm16-append.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_44100,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    std::vector<int16_t> left(1000);
+    std::vector<int16_t> right(1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        left[i] = static_cast<int16_t>(i);
+        right[i] = static_cast<int16_t>(-static_cast<int>(i));
+    }
+    auto writer = WavWriter::create(config);
+    ASSERT_TRUE(writer.has_value());
+    writer->write(600, left.data(), right.data());
+    writer->close_file();
+    /// Reopen and write the rest of the samples
+    auto appender = WavWriter::open_append(config);
+    ASSERT_TRUE(appender.has_value());
+    appender->write(400, left.data() + 600, right.data() + 600);
+    appender->close_file();
+    /// A mismatched configuration must be rejected
+    WavFileConfiguration mismatched = config;
+    mismatched.bitDepth = WavBitDepth::BIT_DEPTH_24;
+    EXPECT_FALSE(WavWriter::open_append(mismatched).has_value());
+    /// Now read it back
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(1000u, reader->get_configuration().num_samples());
+    const auto readSamples = reader->read<int16_t>(1000);
+    ASSERT_EQ(1000u, readSamples[0].size());
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(left[i], readSamples[0][i]);
+        EXPECT_EQ(right[i], readSamples[1][i]);
+    }
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavWriterTest, DirectIoWriteMatchesBufferedWrite) {
+    const WavFileConfiguration config = {
+            .filename = "pcm24-direct-io-write.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_24,
+            .format = WavFormat::PCM,
+    };
+    constexpr size_t numFrames = 10007;
+    std::vector<int32_t> left(numFrames);
+    std::vector<int32_t> right(numFrames);
+    for (size_t i = 0; i < numFrames; ++i) {
+        left[i] = static_cast<int32_t>(i) << 8;
+        right[i] = -static_cast<int32_t>(i) << 8;
+    }
+    /// A small staging buffer, so it is flushed many times
+    auto writer = WavWriter::create(config, {.directIo = true,
+                                             .stagingBytes = 4096});
+    ASSERT_TRUE(writer.has_value());
+    for (size_t frame = 0; frame < numFrames; frame += 333) {
+        const size_t count = std::min<size_t>(333, numFrames - frame);
+        writer->write(count, left.data() + frame, right.data() + frame);
+    }
+    writer->close_file();
+
+    /// The file must not keep the zero padding of the last sector
+    std::ifstream file(config.filename, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<size_t>(file.tellg()), 44 + numFrames * 6);
+    auto reader = WavReader::create(config.filename);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_EQ(numFrames, reader->get_configuration().num_samples());
+    const auto readSamples = reader->read<int32_t>(numFrames);
+    ASSERT_EQ(numFrames, readSamples[0].size());
+    EXPECT_EQ(left, readSamples[0]);
+    EXPECT_EQ(right, readSamples[1]);
+    reader->close_file();
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavWriterTest, MoveAssignmentFinalizesReplacedFile) {
+    WavFileConfiguration config = {
+            .filename = "pcm16-move-assigned-first.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 1,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    const std::vector<int16_t> samples(1001, 1000);
+    auto writer = WavWriter::create(config, {.directIo = true});
+    ASSERT_TRUE(writer.has_value());
+    writer->write(samples.size(), samples.data());
+    const std::string firstFilename = config.filename;
+    config.filename = "pcm16-move-assigned-second.wav";
+    auto other = WavWriter::create(config, {.directIo = true});
+    ASSERT_TRUE(other.has_value());
+    /// Replacing the writer must finish the file it was writing
+    *writer = std::move(*other);
+    writer->write(10, samples.data());
+    writer->close_file();
+
+    auto first = WavReader::create(firstFilename);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(samples.size(), first->get_configuration().num_samples());
+    first->close_file();
+    auto second = WavReader::create(config.filename);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(10u, second->get_configuration().num_samples());
+    second->close_file();
+    std::remove(firstFilename.c_str());
+    std::remove(config.filename.c_str());
+}
+
+TEST(WavWriterTest, DirectIoWriteFailureLeavesHeaderUnfinalized) {
+    const WavFileConfiguration config = {
+            .filename = "pcm16-direct-io-failure.wav",
+            .sampleRate = WavSampleRate::SAMPLE_RATE_48000,
+            .numChannels = 2,
+            .bitDepth = WavBitDepth::BIT_DEPTH_16,
+            .format = WavFormat::PCM,
+    };
+    auto writer = WavWriter::create(config, {.directIo = true,
+                                             .stagingBytes = 4096});
+    ASSERT_TRUE(writer.has_value());
+    if (!writer->is_direct_io()) {
+        writer->close_file();
+        std::remove(config.filename.c_str());
+        GTEST_SKIP() << "O_DIRECT is not supported here";
+    }
+    /// Limit the file size, so writes past 16 KiB fail with EFBIG
+    rlimit previous{};
+    ASSERT_EQ(0, ::getrlimit(RLIMIT_FSIZE, &previous));
+    const auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = previous;
+    limited.rlim_cur = 16384;
+    ASSERT_EQ(0, ::setrlimit(RLIMIT_FSIZE, &limited));
+    const std::vector<int16_t> samples(48000, 1000);
+    writer->write(samples.size(), samples.data(), samples.data());
+    writer->close_file();
+    ::setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, previousHandler);
+    EXPECT_TRUE(writer->has_write_error());
+
+    /// The data size must not claim the audio that was dropped
+    std::ifstream file(config.filename, std::ios::binary);
+    uint32_t dataChunkSize = 1;
+    file.seekg(40, std::ios::beg);
+    file.read(reinterpret_cast<char *>(&dataChunkSize), 4);
+    EXPECT_EQ(0u, dataChunkSize);
+    file.close();
+    std::remove(config.filename.c_str());
+}
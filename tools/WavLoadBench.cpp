@@ -0,0 +1,483 @@
+/// WavLoadBench.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <AudioFileTools/WavLatency.h>
+#include <AudioFileTools/WavReader.h>
+#include <AudioFileTools/WavStats.h>
+#include <AudioFileTools/WavWriter.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+/** The settings of a benchmark run */
+struct LoadBenchOptions {
+    size_t writers = 4;
+    size_t readers = 4;
+    uint8_t channels = 2;
+    std::string format = "pcm16";
+    uint32_t sampleRate = 48000;
+    size_t blockFrames = 480;
+    double seconds = 5.0;
+    bool realtime = true;
+    bool directIo = false;
+    std::string directory = ".";
+    std::string output;
+};
+
+/** The measurements of one writer or reader stream */
+struct StreamResult {
+    bool writer = true;
+    bool opened = false;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    double cpuSeconds = 0.0;
+    WavLatencySummary latency;
+    WavIoStats stats;
+};
+
+/**
+ * @brief Gets the CPU time used by the calling thread.
+ */
+auto thread_cpu_seconds() -> double {
+    timespec time{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<double>(time.tv_sec) +
+           static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+/**
+ * @brief Fills in the bit depth and sample format of a configuration from a
+ * format name.
+ * @return False if the name is not one of pcm8, pcm16, pcm24, pcm32, float
+ */
+auto parse_format(const std::string &name, WavFileConfiguration &config)
+        -> bool {
+    config.format = WavFormat::PCM;
+    if (name == "pcm8") {
+        config.bitDepth = WavBitDepth::BIT_DEPTH_8;
+    } else if (name == "pcm16") {
+        config.bitDepth = WavBitDepth::BIT_DEPTH_16;
+    } else if (name == "pcm24") {
+        config.bitDepth = WavBitDepth::BIT_DEPTH_24;
+    } else if (name == "pcm32") {
+        config.bitDepth = WavBitDepth::BIT_DEPTH_32;
+    } else if (name == "float") {
+        config.bitDepth = WavBitDepth::BIT_DEPTH_32;
+        config.format = WavFormat::FLOAT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the sample rate of a configuration from a rate in hertz.
+ * @return False if the rate is not one of the WavSampleRate values
+ */
+auto parse_sample_rate(const uint32_t rate, WavFileConfiguration &config)
+        -> bool {
+    constexpr std::array rates = {
+            WavSampleRate::SAMPLE_RATE_8000,   WavSampleRate::SAMPLE_RATE_11025,
+            WavSampleRate::SAMPLE_RATE_16000,  WavSampleRate::SAMPLE_RATE_22050,
+            WavSampleRate::SAMPLE_RATE_32000,  WavSampleRate::SAMPLE_RATE_44100,
+            WavSampleRate::SAMPLE_RATE_48000,  WavSampleRate::SAMPLE_RATE_96000,
+            WavSampleRate::SAMPLE_RATE_176400, WavSampleRate::SAMPLE_RATE_192000,
+            WavSampleRate::SAMPLE_RATE_352800, WavSampleRate::SAMPLE_RATE_384000};
+    const auto match = std::ranges::find(rates, rate, [](const auto value) {
+        return static_cast<uint32_t>(value);
+    });
+    if (match == rates.end()) {
+        return false;
+    }
+    config.sampleRate = *match;
+    return true;
+}
+
+/**
+ * @brief Gets the size of one frame of a configuration.
+ * @details The streams count frames themselves rather than taking them from
+ * the I/O statistics, which are compiled out when AUDIO_FILE_TOOLS_STATS is
+ * off.
+ */
+auto frame_bytes(const WavFileConfiguration &config) -> uint64_t {
+    return static_cast<uint64_t>(config.numChannels) *
+           (static_cast<uint64_t>(config.bitDepth) / 8);
+}
+
+/**
+ * @brief Writes a string as a JSON string literal.
+ */
+auto write_json_string(std::ostream &stream, const std::string &text)
+        -> void {
+    stream << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            stream << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
+
+/**
+ * @brief Builds the path of a stream's file.
+ */
+auto stream_path(const LoadBenchOptions &options, const char *kind,
+                 const size_t index) -> std::string {
+    return (std::filesystem::path(options.directory) /
+            ("wav_load_bench_" + std::to_string(::getpid()) + "_" + kind +
+             "_" + std::to_string(index) + ".wav"))
+            .string();
+}
+
+/**
+ * @brief Runs one recording stream: writes blocks of a tone, paced at the
+ * block period or flat out, until the run time is over.
+ */
+auto run_writer(const LoadBenchOptions &options, WavFileConfiguration config,
+                const size_t index, std::latch &start) -> StreamResult {
+    StreamResult result;
+    config.filename = stream_path(options, "writer", index);
+    const uint64_t period = wav_block_period(config, options.blockFrames);
+    auto writer = WavWriter::create(config, {.directIo = options.directIo,
+                                             .collectStats = true,
+                                             .trackLatency = true,
+                                             .deadlineNanoseconds = period});
+    std::vector<std::vector<float>> samples(
+            config.numChannels, std::vector<float>(options.blockFrames));
+    std::vector<const float *> sampleArrays;
+    for (size_t ch = 0; ch < samples.size(); ++ch) {
+        for (size_t i = 0; i < options.blockFrames; ++i) {
+            samples[ch][i] = 0.5f * std::sin(0.01f * static_cast<float>(
+                                                             i * (ch + 1)));
+        }
+        sampleArrays.push_back(samples[ch].data());
+    }
+    start.arrive_and_wait();
+    if (!writer) {
+        return result;
+    }
+    result.opened = true;
+
+    const double cpuStart = thread_cpu_seconds();
+    const auto begin = std::chrono::steady_clock::now();
+    const auto end = begin + std::chrono::duration_cast<
+                                     std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(
+                                             options.seconds));
+    auto next = begin;
+    while (std::chrono::steady_clock::now() < end) {
+        writer->write_buffer(sampleArrays.data(), options.blockFrames);
+        result.frames += options.blockFrames;
+        if (options.realtime) {
+            next += std::chrono::nanoseconds(period);
+            std::this_thread::sleep_until(next);
+        }
+    }
+    result.cpuSeconds = thread_cpu_seconds() - cpuStart;
+    result.latency = writer->get_latency();
+    result.stats = writer->get_stats();
+    result.bytes = result.frames * frame_bytes(config);
+    writer->close_file();
+    std::filesystem::remove(config.filename);
+    return result;
+}
+
+/**
+ * @brief Runs one playback stream: reads blocks of a prepared file, paced at
+ * the block period or flat out, looping at its end, until the run time is
+ * over.
+ */
+auto run_reader(const LoadBenchOptions &options,
+                const WavFileConfiguration &config, const size_t index,
+                std::latch &start) -> StreamResult {
+    StreamResult result;
+    result.writer = false;
+    const std::string filename = stream_path(options, "reader", index);
+    const uint64_t period = wav_block_period(config, options.blockFrames);
+    auto reader = WavReader::create(filename,
+                                    {.sequential = true,
+                                     .directIo = options.directIo,
+                                     .collectStats = true,
+                                     .trackLatency = true,
+                                     .deadlineNanoseconds = period});
+    std::vector<std::vector<float>> samples(
+            config.numChannels, std::vector<float>(options.blockFrames));
+    std::vector<float *> sampleArrays;
+    for (auto &channel : samples) {
+        sampleArrays.push_back(channel.data());
+    }
+    start.arrive_and_wait();
+    if (!reader) {
+        return result;
+    }
+    result.opened = true;
+
+    const double cpuStart = thread_cpu_seconds();
+    const auto begin = std::chrono::steady_clock::now();
+    const auto end = begin + std::chrono::duration_cast<
+                                     std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(
+                                             options.seconds));
+    auto next = begin;
+    while (std::chrono::steady_clock::now() < end) {
+        const size_t framesRead =
+                reader->read_into(options.blockFrames, sampleArrays.data());
+        result.frames += framesRead;
+        if (framesRead < options.blockFrames) {
+            reader->seek_frame(0);
+        }
+        if (options.realtime) {
+            next += std::chrono::nanoseconds(period);
+            std::this_thread::sleep_until(next);
+        }
+    }
+    result.cpuSeconds = thread_cpu_seconds() - cpuStart;
+    result.latency = reader->get_latency();
+    result.stats = reader->get_stats();
+    result.bytes = result.frames * frame_bytes(config);
+    return result;
+}
+
+/**
+ * @brief Writes the file read by a playback stream, a few seconds long so
+ * that it loops while the run lasts.
+ */
+auto prepare_reader_file(const LoadBenchOptions &options,
+                         WavFileConfiguration config, const size_t index)
+        -> bool {
+    config.filename = stream_path(options, "reader", index);
+    auto writer = WavWriter::create(config);
+    if (!writer) {
+        return false;
+    }
+    const size_t frames = static_cast<size_t>(config.sampleRate) *
+                          static_cast<size_t>(std::min(options.seconds, 10.0) +
+                                              1.0);
+    std::vector<std::vector<float>> samples(config.numChannels,
+                                            std::vector<float>(frames, 0.1f));
+    std::vector<const float *> sampleArrays;
+    for (const auto &channel : samples) {
+        sampleArrays.push_back(channel.data());
+    }
+    writer->write_buffer(sampleArrays.data(), frames);
+    writer->close_file();
+    return true;
+}
+
+/**
+ * @brief Writes the report of a run as JSON.
+ */
+auto write_report(std::ostream &stream, const LoadBenchOptions &options,
+                  const std::vector<StreamResult> &results,
+                  const double wallSeconds) -> void {
+    std::array<char, 256> hostname{};
+    ::gethostname(hostname.data(), hostname.size() - 1);
+    uint64_t totalBytes = 0;
+    uint64_t totalFrames = 0;
+    uint64_t totalMisses = 0;
+    double totalCpu = 0.0;
+    for (const auto &result : results) {
+        totalBytes += result.bytes;
+        totalFrames += result.frames;
+        totalMisses += result.latency.deadlineMisses;
+        totalCpu += result.cpuSeconds;
+    }
+    stream << std::fixed << std::setprecision(6);
+    stream << "{\n";
+    stream << "  \"host\": {\"name\": ";
+    write_json_string(stream, hostname.data());
+    stream << ", \"hardware_threads\": "
+           << std::thread::hardware_concurrency() << "},\n";
+    stream << "  \"config\": {\"writers\": " << options.writers
+           << ", \"readers\": " << options.readers
+           << ", \"channels\": " << static_cast<int>(options.channels)
+           << ", \"format\": \"" << options.format
+           << "\", \"sample_rate\": " << options.sampleRate
+           << ", \"block_frames\": " << options.blockFrames
+           << ", \"seconds\": " << options.seconds << ", \"pacing\": \""
+           << (options.realtime ? "realtime" : "flat-out")
+           << "\", \"direct_io\": " << (options.directIo ? "true" : "false")
+           << "},\n";
+    stream << "  \"aggregate\": {\"wall_seconds\": " << wallSeconds
+           << ", \"bytes\": " << totalBytes << ", \"frames\": " << totalFrames
+           << ", \"megabytes_per_second\": "
+           << static_cast<double>(totalBytes) / 1e6 / wallSeconds
+           << ", \"realtime_factor\": "
+           << static_cast<double>(totalFrames) /
+                      (static_cast<double>(options.sampleRate) * wallSeconds)
+           << ", \"cpu_seconds\": " << totalCpu
+           << ", \"deadline_misses\": " << totalMisses << "},\n";
+    stream << "  \"streams\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &result = results[i];
+        stream << "    {\"kind\": \""
+               << (result.writer ? "writer" : "reader")
+               << "\", \"opened\": " << (result.opened ? "true" : "false")
+               << ", \"frames\": " << result.frames
+               << ", \"bytes\": " << result.bytes
+               << ", \"cpu_seconds\": " << result.cpuSeconds
+               << ", \"calls\": " << result.latency.count
+               << ", \"deadline_misses\": " << result.latency.deadlineMisses
+               << ", \"latency_ns\": {\"p50\": " << result.latency.p50
+               << ", \"p99\": " << result.latency.p99
+               << ", \"p999\": " << result.latency.p999
+               << ", \"max\": " << result.latency.max << "}"
+               << ", \"io_ns\": " << result.stats.ioNanoseconds
+               << ", \"conversion_ns\": "
+               << result.stats.conversionNanoseconds
+               << ", \"interleave_ns\": "
+               << result.stats.interleaveNanoseconds << "}"
+               << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    stream << "  ]\n}\n";
+}
+} // namespace
+
+/**
+ * @brief Runs concurrent recording and playback streams and prints a JSON
+ * report of throughput, per-stream latency percentiles, CPU time and
+ * deadline misses.
+ * @details Usage: WavLoadBench [--writers n] [--readers n] [--channels n]
+ * [--format pcm8|pcm16|pcm24|pcm32|float] [--rate hz] [--block frames]
+ * [--seconds s] [--flat-out] [--direct] [--dir path] [--output file]
+ */
+auto main(int argc, char **argv) -> int {
+    LoadBenchOptions options;
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--writers" && hasValue) {
+            options.writers = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--readers" && hasValue) {
+            options.readers = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--channels" && hasValue) {
+            options.channels = static_cast<uint8_t>(
+                    std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--format" && hasValue) {
+            options.format = argv[++i];
+        } else if (arg == "--rate" && hasValue) {
+            options.sampleRate = static_cast<uint32_t>(
+                    std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--block" && hasValue) {
+            options.blockFrames = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--seconds" && hasValue) {
+            options.seconds = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--flat-out") {
+            options.realtime = false;
+        } else if (arg == "--direct") {
+            options.directIo = true;
+        } else if (arg == "--dir" && hasValue) {
+            options.directory = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            options.output = argv[++i];
+        } else {
+            valid = false;
+        }
+    }
+    WavFileConfiguration config = {.filename = {},
+                                   .numChannels = options.channels};
+    if (!valid || !parse_format(options.format, config) ||
+        !parse_sample_rate(options.sampleRate, config) ||
+        options.channels == 0 || options.blockFrames == 0 ||
+        options.writers + options.readers == 0 || options.seconds <= 0.0) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--writers n] [--readers n] [--channels n]"
+                     " [--format pcm8|pcm16|pcm24|pcm32|float] [--rate hz]"
+                     " [--block frames] [--seconds s] [--flat-out]"
+                     " [--direct] [--dir path] [--output file]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < options.readers; ++i) {
+        if (!prepare_reader_file(options, config, i)) {
+            std::cerr << "Could not create "
+                      << stream_path(options, "reader", i) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    /// Every stream opens its file, then they all start together
+    const size_t numStreams = options.writers + options.readers;
+    std::vector<StreamResult> results(numStreams);
+    std::latch start(static_cast<std::ptrdiff_t>(numStreams + 1));
+    std::vector<std::thread> threads;
+    threads.reserve(numStreams);
+    for (size_t i = 0; i < options.writers; ++i) {
+        threads.emplace_back([&, i] {
+            results[i] = run_writer(options, config, i, start);
+        });
+    }
+    for (size_t i = 0; i < options.readers; ++i) {
+        threads.emplace_back([&, i] {
+            results[options.writers + i] =
+                    run_reader(options, config, i, start);
+        });
+    }
+    start.arrive_and_wait();
+    const auto begin = std::chrono::steady_clock::now();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const double wallSeconds = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - begin)
+                                       .count();
+    for (size_t i = 0; i < options.readers; ++i) {
+        std::filesystem::remove(stream_path(options, "reader", i));
+    }
+
+    if (options.output.empty()) {
+        write_report(std::cout, options, results, wallSeconds);
+    } else {
+        std::ofstream output(options.output);
+        write_report(output, options, results, wallSeconds);
+    }
+    for (const auto &result : results) {
+        if (!result.opened) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/// WavRepair.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavRepair.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Repairs the headers of the WAV files given on the command line.
+ * @details Usage: WavRepair [-j threads] file...
+ */
+auto main(int argc, char **argv) -> int {
+    size_t numThreads = 0;
+    std::vector<std::string> filenames;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            numThreads = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            filenames.push_back(arg);
+        }
+    }
+    if (filenames.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [-j threads] file..."
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto results = repair_wav_headers(filenames, numThreads);
+    int status = EXIT_SUCCESS;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        if (results[i]) {
+            std::cout << filenames[i] << ": " << results[i]->num_samples()
+                      << " samples" << std::endl;
+        } else {
+            std::cerr << filenames[i] << ": not a repairable WAV file"
+                      << std::endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,97 @@
+/// WavVerify.cpp
+
+
+/**
+Copyright © 2025 Alex Parisi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <AudioFileTools/WavVerify.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Verifies WAV files and prints a JSON report.
+ * @details Usage: WavVerify [-j threads] [--hash] (file... | --list path).
+ * The list holds one filename per line and is read from stdin when the path
+ * is -, so archives too large for the command line can be verified. Reports
+ * are printed as each file finishes, in completion order.
+ */
+auto main(int argc, char **argv) -> int {
+    WavVerifyOptions options;
+    std::string listPath;
+    std::ostringstream arguments;
+    bool hasArguments = false;
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            options.numThreads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--hash") {
+            options.checkHash = true;
+        } else if (arg == "--list" && i + 1 < argc && listPath.empty()) {
+            listPath = argv[++i];
+        } else if (arg == "--list") {
+            valid = false;
+        } else {
+            arguments << arg << '\n';
+            hasArguments = true;
+        }
+    }
+    if (!valid || hasArguments == !listPath.empty()) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-j threads] [--hash] (file... | --list path)"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::istringstream argumentList(arguments.str());
+    std::ifstream listFile;
+    std::istream *list = &argumentList;
+    if (listPath == "-") {
+        list = &std::cin;
+    } else if (!listPath.empty()) {
+        listFile.open(listPath);
+        if (!listFile) {
+            std::cerr << "Could not open " << listPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        list = &listFile;
+    }
+
+    bool allValid = true;
+    bool first = true;
+    std::cout << "[\n";
+    verify_wav_files(
+            *list,
+            [&](size_t, const WavVerifyReport &report) {
+                std::cout << (first ? "  " : ",\n  ");
+                write_wav_verify_json(std::cout, report);
+                first = false;
+                allValid = allValid && report.valid();
+            },
+            options);
+    std::cout << (first ? "" : "\n") << "]" << std::endl;
+    return allValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}